@@ -7,6 +7,8 @@
 
 //====| STL Includes |====//
 #include <stdio.h>
+#include <iostream>
+#include <iomanip>
 
 //====| Namespaces |====//
 using namespace std;
@@ -21,6 +23,9 @@ private:
     int start_time;
     int run_time; // Time process needs to complete
     int cpu_time; // Time process has spent on CPU
+    int ready_since;   // Time the process last entered a ready queue
+    int wait_time;     // Time process has spent in ready queues
+    int response_time; // Time from start to first run on a CPU, -1 until then
 
 public:
     //----| Constructor(s) |----//
@@ -30,20 +35,30 @@ public:
         priority = 0;
         start_time = Time;
         cpu_time = 0;
+        ready_since = Time;
+        wait_time = 0;
+        response_time = -1;
     }
     //----| Getters |----//
-    int getPID() { return pid; }
-    int getPriority() { return priority; }
-    int getValue() { return value; }
-    int getStart() { return start_time; }
-    int getRun() { return run_time; }
-    int getCPU() { return cpu_time; }
+    int getPID() const { return pid; }
+    int getPriority() const { return priority; }
+    int getValue() const { return value; }
+    int getStart() const { return start_time; }
+    int getRun() const { return run_time; }
+    int getCPU() const { return cpu_time; }
+    int getReadySince() const { return ready_since; }
+    int getWait() const { return wait_time; }
+    int getResponse() const { return response_time; }
 
     //----| Setters |----//
     void setValue(int val)
     {
         value = val;
     }
+    void setPriority(int level)
+    {
+        priority = level;
+    }
     void incrementPriority()
     {
         if (priority < 3)
@@ -58,9 +73,25 @@ public:
             priority--;
         }
     }
+    void setReady(int Time)
+    {
+        ready_since = Time;
+    }
+    void dispatch(int Time) // Process goes from a ready queue onto a CPU
+    {
+        wait_time += Time - ready_since;
+        if (response_time < 0)
+        {
+            response_time = Time - start_time;
+        }
+    }
     bool incrementTime()
     {
-        cpu_time++;
+        return addTime(1);
+    };
+    bool addTime(int ticks)
+    {
+        cpu_time += ticks;
         if (cpu_time >= run_time)
         {
             return true;
@@ -72,14 +103,22 @@ public:
     friend ostream &operator<<(ostream &out, const PCB &pcb);
 };
 
-ostream &operator<<(ostream &out, const PCB &pcb)
+/*
+    Prints one row of the reporter's PCB table. Shared by PCB and the PCBStore's PCBRef.
+*/
+inline ostream &printPCB(ostream &out, int pid, int priority, int value, int start_time, int cpu_time)
 {
-    out << setw(2) << pcb.pid << "  "
-        << setw(4) << pcb.priority << "  "
-        << setw(7) << pcb.value << "  "
-        << setw(11) << pcb.start_time << "  "
-        << setw(8) << pcb.cpu_time << endl;
+    out << setw(2) << pid << "  "
+        << setw(4) << priority << "  "
+        << setw(7) << value << "  "
+        << setw(11) << start_time << "  "
+        << setw(8) << cpu_time << endl;
     return out;
 }
 
+inline ostream &operator<<(ostream &out, const PCB &pcb)
+{
+    return printPCB(out, pcb.pid, pcb.priority, pcb.value, pcb.start_time, pcb.cpu_time);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,382 @@
+/*
+    Description:
+        Command-stream throughput benchmark. A forked producer streams the same command mix
+        to the parent over a pipe in two ways:
+            text:   one NUL-terminated line per write(), read back one byte per read() (the original path)
+            binary: batched Command records, decoded from large buffered reads
+            shm:    Command records through the shared-memory ShmRing (commander -m)
+        and the parent reports decoded commands per second for each. The pipe and the ring are also timed
+        ping-ponging one command at a time (half a round trip = one-way latency).
+        It also times parsing text lines alone: parseCommand against the original istringstream tokenizer
+        (commander's validateInput followed by the old parseCommand), in ns per command.
+        Usage: command_stream_bench [commands]
+*/
+
+//====| STL Includes |====//
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//====| Local Includes |====//
+#include "../command.h"
+#include "../shm_ring.h"
+
+//====| Namespace |====//
+using namespace std;
+
+//====| Function Definitions |====//
+
+/*
+    Builds a repeating command mix shaped like prog2_input.txt.
+*/
+vector<string> makeCommands(int n)
+{
+    const char *mix[] = {"S 12 135 9", "Q", "C A 5", "B 1", "Q", "U 1", "C M 4", "Q", "S 7 10 15", "C D 2"};
+    vector<string> cmds;
+    for (int i = 0; i < n; i++)
+    {
+        cmds.push_back(mix[i % 10]);
+    }
+    return cmds;
+}
+
+/*
+    The original text path: validateInput and parseCommand each split the line into a vector<string>
+    with an istringstream and read the numbers with atoi.
+*/
+bool legacyDigit(const string &input)
+{
+    for (char ch : input)
+    {
+        if (!isdigit(ch))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool legacyParse(const string &input, Command &cmd)
+{
+    istringstream check(input);
+    string s;
+    vector<string> args;
+    while (getline(check, s, ' '))
+    {
+        args.push_back(s);
+    }
+    bool valid;
+    switch (args[0][0])
+    {
+    case 'S':
+        valid = legacyDigit(args[1]) && legacyDigit(args[2]) && legacyDigit(args[3]) && args.size() == 4;
+        break;
+    case 'B':
+    case 'U':
+        valid = (args.size() == 2 || (args.size() == 3 && legacyDigit(args[2]))) && legacyDigit(args[1]);
+        break;
+    case 'C':
+        valid = (args.size() == 3 || (args.size() == 4 && legacyDigit(args[3]))) && (args[1] == "A" || args[1] == "S" || args[1] == "M" || args[1] == "D") && legacyDigit(args[2]);
+        break;
+    default:
+        valid = args.size() == 1;
+    }
+    if (!valid)
+    {
+        return false;
+    }
+    istringstream iss(input);
+    args.clear();
+    while (getline(iss, s, ' '))
+    {
+        args.push_back(s);
+    }
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.op = input[0];
+    switch (cmd.op)
+    {
+    case 'S':
+        cmd.arg[0] = atoi(args[1].c_str());
+        cmd.arg[1] = atoi(args[2].c_str());
+        cmd.arg[2] = atoi(args[3].c_str());
+        break;
+    case 'B':
+    case 'U':
+        cmd.arg[0] = atoi(args[1].c_str());
+        cmd.arg[1] = args.size() > 2 ? atoi(args[2].c_str()) : -1;
+        break;
+    case 'C':
+        cmd.cop = args[1][0];
+        cmd.arg[0] = atoi(args[2].c_str());
+        cmd.arg[1] = args.size() > 3 ? atoi(args[3].c_str()) : -1;
+        break;
+    case 'Q':
+        cmd.arg[0] = 1;
+        break;
+    }
+    return true;
+}
+
+/*
+    Nanoseconds per command for parse over every line of cmds (best of three passes).
+*/
+template <class Parse>
+double timeParse(const vector<string> &cmds, Parse parse)
+{
+    double best = 0;
+    for (int pass = 0; pass < 3; pass++)
+    {
+        Command cmd;
+        long long checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string &line : cmds)
+        {
+            checksum += parse(line, cmd) + cmd.arg[0];
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / cmds.size();
+        if (pass == 0 || ns < best)
+        {
+            best = ns;
+        }
+        if (checksum == -1)
+        {
+            cout << ""; // Keeps the loop from being optimized away
+        }
+    }
+    return best;
+}
+
+/*
+    Forks a producer that runs produce(fd), times the parent consuming the stream with consume(fd),
+    and returns commands per second.
+*/
+template <class Produce, class Consume>
+double run(int n, Produce produce, Consume consume)
+{
+    int fds[2];
+    if (pipe(fds))
+    {
+        perror("unable to create the pipe");
+        exit(1);
+    }
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(fds[0]);
+        produce(fds[1]);
+        close(fds[1]);
+        exit(0);
+    }
+    close(fds[1]);
+    auto start = chrono::steady_clock::now();
+    int got = consume(fds[0]);
+    auto end = chrono::steady_clock::now();
+    close(fds[0]);
+    waitpid(child, NULL, 0);
+    if (got != n)
+    {
+        cout << "decoded " << got << " of " << n << " commands" << endl;
+    }
+    return n / chrono::duration<double>(end - start).count();
+}
+
+/*
+    Nanoseconds per one-way hop of a command bounced between the parent and a forked echo child, over
+    a pair of pipes or a pair of ShmRings.
+*/
+double pingPongPipe(int n)
+{
+    int there[2], back[2];
+    if (pipe(there) || pipe(back))
+    {
+        perror("unable to create the pipes");
+        exit(1);
+    }
+    Command cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    if (fork() == 0)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (read(there[0], &cmd, sizeof(cmd)) != sizeof(cmd) || write(back[1], &cmd, sizeof(cmd)) != sizeof(cmd))
+            {
+                break;
+            }
+        }
+        exit(0);
+    }
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+    {
+        if (write(there[1], &cmd, sizeof(cmd)) != sizeof(cmd) || read(back[0], &cmd, sizeof(cmd)) != sizeof(cmd))
+        {
+            break;
+        }
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (2.0 * n);
+    wait(NULL);
+    close(there[0]), close(there[1]), close(back[0]), close(back[1]);
+    return ns;
+}
+
+double pingPongShm(int n)
+{
+    int thereFd, backFd;
+    ShmRing *there = ShmRing::create(thereFd);
+    ShmRing *back = ShmRing::create(backFd);
+    if (there == NULL || back == NULL)
+    {
+        exit(1);
+    }
+    Command cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.op = 'Q';
+    if (fork() == 0)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            there->pop(cmd);
+            back->push(cmd);
+            back->flush();
+        }
+        exit(0);
+    }
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+    {
+        there->push(cmd);
+        there->flush();
+        back->pop(cmd);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (2.0 * n);
+    wait(NULL);
+    close(thereFd), close(backFd);
+    return ns;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 200000;
+    vector<string> cmds = makeCommands(n);
+    vector<Command> records(n);
+    for (int i = 0; i < n; i++)
+    {
+        parseCommand(cmds[i], records[i]);
+    }
+
+    double text = run(
+        n,
+        [&](int fd)
+        {
+            for (const string &line : cmds)
+            {
+                write(fd, line.c_str(), line.size() + 1);
+            }
+        },
+        [&](int fd)
+        {
+            int count = 0;
+            char chr;
+            string str = "";
+            Command cmd;
+            while (read(fd, &chr, 1) == 1)
+            {
+                if (chr != 0)
+                {
+                    str.push_back(chr);
+                }
+                else
+                {
+                    parseCommand(str, cmd);
+                    count++;
+                    str = "";
+                }
+            }
+            return count;
+        });
+
+    double binary = run(
+        n,
+        [&](int fd)
+        {
+            CommandWriter writer(fd);
+            for (const Command &cmd : records)
+            {
+                writer.push(cmd);
+            }
+            writer.flush();
+        },
+        [&](int fd)
+        {
+            int count = 0;
+            CommandReader reader(fd);
+            Command cmd;
+            while (reader.read(cmd))
+            {
+                count++;
+            }
+            return count;
+        });
+
+    int ringFd;
+    ShmRing *sharedRing = ShmRing::create(ringFd); // Mapped before the fork, so the producer shares it
+    if (sharedRing == NULL)
+    {
+        exit(1);
+    }
+    double shm = run(
+        n,
+        [&](int)
+        {
+            for (const Command &cmd : records)
+            {
+                sharedRing->push(cmd);
+            }
+            sharedRing->close();
+        },
+        [&](int)
+        {
+            int count = 0;
+            Command cmd;
+            while (true)
+            {
+                sharedRing->pop(cmd);
+                if (cmd.op == END_OF_STREAM)
+                {
+                    return count;
+                }
+                count++;
+            }
+        });
+    double pipeHop = pingPongPipe(20000);
+    double shmHop = pingPongShm(20000);
+
+    double legacyNs = timeParse(cmds, [](const string &line, Command &cmd)
+                                { return legacyParse(line, cmd); });
+    double parseNs = timeParse(cmds, [](const string &line, Command &cmd)
+                               { return parseCommand(line, cmd); });
+
+    cout << fixed << setprecision(0)
+         << "commands:        " << n << endl
+         << "text  (cmds/s):  " << text << endl
+         << "binary (cmds/s): " << binary << endl
+         << setprecision(1)
+         << "speedup:         " << binary / text << "x" << endl
+         << setprecision(0)
+         << "shm (cmds/s):    " << shm << endl
+         << setprecision(1)
+         << "shm vs binary:   " << shm / binary << "x" << endl
+         << "pipe hop (ns):   " << pipeHop << endl
+         << "shm hop (ns):    " << shmHop << endl
+         << setprecision(2)
+         << "istringstream parse (ns/cmd): " << legacyNs << endl
+         << "parseCommand (ns/cmd):        " << parseNs << endl
+         << setprecision(1)
+         << "parse speedup:                " << legacyNs / parseNs << "x" << endl;
+    return 0;
+}
@@ -0,0 +1,12 @@
+#!/bin/sh
+# Lines up the "name value" results of two benchmark runs and prints the change for each metric.
+# Usage: bench/compare.sh baseline.txt results.txt
+awk '
+    NF == 2 && $2 ~ /^[0-9.]+$/ {
+        if (FNR == NR) { base[$1] = $2; next }
+        if ($1 in base) {
+            change = base[$1] == 0 ? 0 : 100 * ($2 - base[$1]) / base[$1]
+            printf "%-32s %14s %14s %+8.1f%%\n", $1, base[$1], $2, change
+        }
+    }
+' "$1" "$2"
@@ -0,0 +1,184 @@
+/*
+    Description:
+        End-to-end benchmark of Process_Manager::digestInput on synthetic workloads (or a trace file).
+        Each workload runs twice on a fresh manager: once untimed per command for throughput, and once
+        timing every command for the p50/p99 latency. P and T are skipped so the reporter does not print.
+        The mixed workload is then run once more under each scheduling policy (policy.<name>.mixed.*), and a
+        crowded workload (thousands of runnable processes) under the default policy and the CFS engine.
+        mixed.traced repeats the mixed workload with the event trace on (written to /dev/null).
+        Built with -DPM_STATS (bench/manager_bench_stats) it runs the basic workloads only, named stats.*, so
+        the cost of the instrumentation is the difference from the same lines without the prefix.
+        Output is one "workload.metric value" line per result, which bench/compare.sh lines up against a baseline.
+        Usage: manager_bench [-n commands] [-f trace_file]
+*/
+
+//====| STL Includes |====//
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unistd.h>
+
+//====| Local Includes |====//
+#include "../process_manager.h"
+#include "workload.h"
+
+//====| Namespace |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#ifdef PM_STATS
+#define RESULT_PREFIX "stats."
+#else
+#define RESULT_PREFIX ""
+#endif
+
+//====| Function Definitions |====//
+
+/*
+    Runs every command of trace through a fresh manager and prints throughput and latency percentiles.
+    With a tracePath, the managers also record their scheduling events there.
+*/
+template <class Policy = PM_POLICY>
+void run(const string &name, vector<string> trace, const char *tracePath = NULL)
+{
+    trace.erase(remove_if(trace.begin(), trace.end(), [](const string &line)
+                          { return line.empty() || line[0] == 'P' || line[0] == 'T'; }),
+                trace.end());
+    size_t n = trace.size();
+    if (n == 0)
+    {
+        return;
+    }
+
+    double seconds;
+    {
+        Process_Manager<Policy> pm;
+        EventTrace *events = tracePath == NULL ? NULL : new EventTrace(tracePath, Policy::name, 1, Policy::levels);
+        pm.setTrace(events);
+        auto start = chrono::steady_clock::now();
+        for (const string &line : trace)
+        {
+            pm.digestInput(line);
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        pm.setTrace(NULL);
+        delete events;
+    }
+
+    vector<long long> latency(n);
+    {
+        Process_Manager<Policy> pm;
+        EventTrace *events = tracePath == NULL ? NULL : new EventTrace(tracePath, Policy::name, 1, Policy::levels);
+        pm.setTrace(events);
+        for (size_t i = 0; i < n; i++)
+        {
+            auto start = chrono::steady_clock::now();
+            pm.digestInput(trace[i]);
+            latency[i] = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        }
+        pm.setTrace(NULL);
+        delete events;
+    }
+    nth_element(latency.begin(), latency.begin() + n / 2, latency.end());
+    long long p50 = latency[n / 2];
+    nth_element(latency.begin(), latency.begin() + n * 99 / 100, latency.end());
+    long long p99 = latency[n * 99 / 100];
+
+    string result = RESULT_PREFIX + name;
+    cout << result << ".commands " << n << endl
+         << result << ".cmds_per_sec " << (long long)(n / seconds) << endl
+         << result << ".p50_ns " << p50 << endl
+         << result << ".p99_ns " << p99 << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    long long commands = 1000000;
+    const char *traceFile = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:f:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            commands = atoll(optarg);
+            break;
+        case 'f':
+            traceFile = optarg;
+            break;
+        default:
+            cerr << "usage: " << argv[0] << " [-n commands] [-f trace_file]" << endl;
+            exit(1);
+        }
+    }
+
+    if (traceFile != NULL)
+    {
+        ifstream in(traceFile);
+        vector<string> trace;
+        string line;
+        while (getline(in, line))
+        {
+            trace.push_back(line);
+        }
+        run("trace", trace);
+        return 0;
+    }
+
+    WorkloadConfig mixed;
+    mixed.commands = commands;
+    vector<string> mixedTrace = generateWorkload(mixed);
+    run("mixed", mixedTrace);
+    run("mixed.traced", mixedTrace, "/dev/null");
+
+    WorkloadConfig cpuBound = mixed;
+    cpuBound.blockRatio = cpuBound.unblockRatio = 0.01;
+    cpuBound.cRatio = 0.1;
+    cpuBound.processes = commands / 1000;
+    cpuBound.minRun = 100;
+    cpuBound.maxRun = 1000;
+    run("cpu_bound", generateWorkload(cpuBound));
+
+    WorkloadConfig blockHeavy = mixed;
+    blockHeavy.blockRatio = blockHeavy.unblockRatio = 0.25;
+    blockHeavy.processes = commands / 10;
+    run("block_heavy", generateWorkload(blockHeavy));
+
+    WorkloadConfig manyResources = blockHeavy;
+    manyResources.resources = 1000;
+    run("many_resources", generateWorkload(manyResources));
+
+    WorkloadConfig timedIO = blockHeavy;
+    timedIO.unblockRatio = 0;
+    timedIO.maxTimeout = 50;
+    run("timed_io", generateWorkload(timedIO));
+
+    WorkloadConfig fastForward = mixed;
+    fastForward.maxTicks = 64;
+    fastForward.runDist = 'e';
+    fastForward.meanRun = 200;
+    run("fast_forward", generateWorkload(fastForward));
+#ifdef PM_STATS
+    return 0; // The instrumentation costs the same under every policy
+#endif
+
+    run<MLFQPolicy>(string("policy.") + MLFQPolicy::name + ".mixed", mixedTrace);
+    run<RoundRobinPolicy>(string("policy.") + RoundRobinPolicy::name + ".mixed", mixedTrace);
+    run<PriorityPolicy>(string("policy.") + PriorityPolicy::name + ".mixed", mixedTrace);
+    run<LotteryPolicy>(string("policy.") + LotteryPolicy::name + ".mixed", mixedTrace);
+    run<FairSharePolicy>(string("policy.") + FairSharePolicy::name + ".mixed", mixedTrace);
+    run<CFSPolicy>(string("policy.") + CFSPolicy::name + ".mixed", mixedTrace);
+
+    WorkloadConfig crowded = mixed;
+    crowded.blockRatio = crowded.unblockRatio = 0.01;
+    crowded.processes = commands / 4;
+    crowded.minRun = 1000;
+    crowded.maxRun = 5000;
+    vector<string> crowdedTrace = generateWorkload(crowded);
+    run<PM_POLICY>(string("policy.") + PM_POLICY::name + ".crowded", crowdedTrace);
+    run<CFSPolicy>(string("policy.") + CFSPolicy::name + ".crowded", crowdedTrace);
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*
+    Description:
+        Compares bulk passes over every process on the original array-of-structs PCB table
+        against the structure-of-arrays PCBStore, at 10k and 1M processes:
+            finished: count processes whose cpu_time has reached run_time (completion check)
+            cpu:      sum cpu_time over all processes (reporting)
+            age:      move every process one priority level toward 0 (aging)
+*/
+
+//====| STL Includes |====//
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+
+//====| Local Includes |====//
+#include "../PCB.h"
+#include "../pcb_store.h"
+
+//====| Namespace |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define WORK 200000000LL // PCB visits per measurement
+
+//====| Function Definitions |====//
+
+/*
+    The SoA passes walk one or two columns per chunk with branch-free bodies so the compiler can vectorize them.
+    They are only used here: the manager never scans every PCB (completion is checked for the running
+    processes and aging is lazy), so PCBStore only offers the chunks.
+*/
+long long countFinished(PCBStore &store) // Live PCBs whose cpu_time has reached run_time
+{
+    long long count = 0;
+    store.forEachChunk([&](const PCBChunk &c, int n)
+                       {
+                           for (int i = 0; i < n; i++)
+                           {
+                               count += c.live[i] & (c.cpu_time[i] >= c.run_time[i]);
+                           } });
+    return count;
+}
+
+long long totalCPU(PCBStore &store) // Sum of cpu_time over live PCBs
+{
+    long long sum = 0;
+    store.forEachChunk([&](const PCBChunk &c, int n)
+                       {
+                           for (int i = 0; i < n; i++)
+                           {
+                               sum += c.live[i] * c.cpu_time[i];
+                           } });
+    return sum;
+}
+
+void promoteAll(PCBStore &store) // Moves every live PCB one priority level up (toward 0)
+{
+    store.forEachChunk([](PCBChunk &c, int n)
+                       {
+                           for (int i = 0; i < n; i++)
+                           {
+                               c.priority[i] -= c.live[i] & (c.priority[i] > 0);
+                           } });
+}
+
+/*
+    Runs pass reps times and returns nanoseconds per PCB visited.
+*/
+template <class Pass>
+double measure(long long n, Pass pass)
+{
+    long long reps = WORK / n > 0 ? WORK / n : 1;
+    auto start = chrono::steady_clock::now();
+    for (long long r = 0; r < reps; r++)
+    {
+        long long result = pass();
+        asm volatile("" : : "r"(result), "g"(&pass) : "memory"); // Keep the compiler from dropping or hoisting the pass
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / (reps * n);
+}
+
+void report(const char *name, double aos, double soa)
+{
+    cout << "  " << left << setw(10) << name << right << fixed << setprecision(3)
+         << setw(10) << aos << setw(10) << soa
+         << setw(8) << setprecision(1) << aos / soa << "x" << endl;
+}
+
+int main()
+{
+    int sizes[] = {10000, 1000000};
+    for (int n : sizes)
+    {
+        PCB *table = new PCB[n];
+        PCBStore store;
+        srand(n);
+        for (int i = 0; i < n; i++)
+        {
+            PCB pcb(i, rand() % 100, 1 + rand() % 10, rand() % 1000);
+            for (int k = rand() % 10; k > 0; k--)
+            {
+                pcb.incrementTime();
+                pcb.incrementPriority();
+            }
+            table[i] = pcb;
+            store.insert(pcb);
+        }
+
+        cout << n << " processes (ns per PCB)" << endl
+             << "  pass             AoS       SoA  speedup" << endl;
+        report("finished",
+               measure(n, [&]()
+                       {
+                           long long count = 0;
+                           for (int i = 0; i < n; i++)
+                           {
+                               count += table[i].getCPU() >= table[i].getRun();
+                           }
+                           return count; }),
+               measure(n, [&]()
+                       { return countFinished(store); }));
+        report("cpu",
+               measure(n, [&]()
+                       {
+                           long long sum = 0;
+                           for (int i = 0; i < n; i++)
+                           {
+                               sum += table[i].getCPU();
+                           }
+                           return sum; }),
+               measure(n, [&]()
+                       { return totalCPU(store); }));
+        report("age",
+               measure(n, [&]()
+                       {
+                           for (int i = 0; i < n; i++)
+                           {
+                               table[i].decrementPriority();
+                           }
+                           return (long long)table[0].getPriority(); }),
+               measure(n, [&]()
+                       {
+                           promoteAll(store);
+                           return 0LL; }));
+        delete[] table;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+    Description:
+        Microbenchmark for QueueArray::Dequeue. Compares the bitmap lookup against the
+        original linear scan over every level at 4, 64 and 1024 levels.
+        Each iteration dequeues one item and enqueues one item at a random level, keeping
+        a small, steady population so that most levels are empty (the common case for the scheduler).
+*/
+
+//====| STL Includes |====//
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <queue>
+#include <cstdlib>
+
+//====| Local Includes |====//
+#include "../queue_array.h"
+
+//====| Namespace |====//
+using namespace std;
+
+//====| Baseline |====//
+
+/*
+    The original QueueArray dequeue: checks the size of every level until one is non-empty.
+*/
+template <class T>
+class LinearQueueArray
+{
+public:
+    LinearQueueArray(int sz) : size(sz), array(new queue<T>[sz]) {}
+    ~LinearQueueArray() { delete[] array; }
+    int Enqueue(const T &item, const int index)
+    {
+        array[index].emplace(item);
+        return 1;
+    }
+    T Dequeue()
+    {
+        for (int i = 0; i < size; i++)
+        {
+            if (array[i].size() >= 1)
+            {
+                T val = array[i].front();
+                array[i].pop();
+                return val;
+            }
+        }
+        return 0;
+    }
+
+private:
+    int size;
+    queue<T> *array;
+};
+
+//====| Globals Variables |====//
+#define POPULATION 16
+#define ITERATIONS 2000000
+
+//====| Function Definitions |====//
+
+/*
+    Returns nanoseconds per Dequeue + Enqueue pair for queue type Q with levels levels.
+    Items are enqueued towards the low-priority end so the linear scan has to walk most of the array.
+*/
+template <class Q>
+double run(int levels, const int *targets)
+{
+    Q q(levels);
+    for (int i = 0; i < POPULATION; i++)
+    {
+        q.Enqueue(i, targets[i]);
+    }
+    long long sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        int pid = q.Dequeue();
+        sink += pid;
+        q.Enqueue(pid, targets[i]);
+    }
+    auto end = chrono::steady_clock::now();
+    if (sink == -1)
+    {
+        cout << sink;
+    }
+    return chrono::duration<double, nano>(end - start).count() / ITERATIONS;
+}
+
+int main()
+{
+    int levelCounts[] = {4, 64, 1024};
+    int *targets = new int[ITERATIONS];
+
+    cout << "levels  linear(ns/op)  bitmap(ns/op)  speedup" << endl;
+    for (int levels : levelCounts)
+    {
+        srand(levels);
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            targets[i] = levels - 1 - rand() % (levels < 4 ? levels : levels / 4); // bottom quarter of the levels
+        }
+        double linear = run<LinearQueueArray<int>>(levels, targets);
+        double bitmap = run<QueueArray<int>>(levels, targets);
+        cout << setw(6) << levels << "  "
+             << setw(13) << fixed << setprecision(2) << linear << "  "
+             << setw(13) << bitmap << "  "
+             << setw(6) << setprecision(1) << linear / bitmap << "x" << endl;
+    }
+    delete[] targets;
+    return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+/*
+    Synthetic workload generator shared by workload_gen and manager_bench.
+    Produces a valid text command stream (the format commander reads) with a configurable number of
+    processes, run-time distribution, block/unblock ratios and C operation mix.
+*/
+//====| STL Includes |====//
+#include <string>
+#include <vector>
+#include <random>
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Config |====//
+struct WorkloadConfig
+{
+    long long commands = 1000000; // Commands to emit (not counting the final T)
+    int processes = 10000;        // Processes created with S, spread evenly over the stream
+    char runDist = 'u';           // 'u': uniform in [minRun, maxRun]; 'e': exponential with mean meanRun
+    int minRun = 1;
+    int maxRun = 50;
+    double meanRun = 20;
+    double blockRatio = 0.05;     // Fraction of commands that are B
+    double unblockRatio = 0.05;   // Fraction of commands that are U
+    double cRatio = 0.3;          // Fraction of commands that are C
+    int cMix[4] = {1, 1, 1, 1};   // Relative weights of C A / C S / C M / C D
+    double reportRatio = 0;       // Fraction of commands that are P
+    int resources = 3;            // B/U pick a resource in [0, resources)
+    int maxTimeout = 0;           // If > 0, B times out after [1, maxTimeout] ticks (B rid 0 timeout)
+    int maxTicks = 1;             // Q n with n uniform in [1, maxTicks]
+    bool terminate = true;        // End the stream with T
+    unsigned seed = 1;
+};
+
+//====| Function Definitions |====//
+
+/*
+    Generates the command stream for config. The rest of the mix (after S, B, U, C and P) is Q.
+*/
+vector<string> generateWorkload(const WorkloadConfig &config)
+{
+    mt19937 rng(config.seed);
+    uniform_real_distribution<double> pick(0, 1);
+    uniform_int_distribution<int> uniformRun(config.minRun, config.maxRun);
+    exponential_distribution<double> exponentialRun(1.0 / config.meanRun);
+    uniform_int_distribution<int> resource(0, config.resources - 1);
+    uniform_int_distribution<int> operand(1, 9); // Never 0, so C D cannot divide by zero
+    uniform_int_distribution<int> ticks(1, config.maxTicks);
+    uniform_int_distribution<int> timeout(1, config.maxTimeout > 0 ? config.maxTimeout : 1);
+    discrete_distribution<int> cOp(config.cMix, config.cMix + 4);
+    const char ops[] = {'A', 'S', 'M', 'D'};
+
+    vector<string> out;
+    out.reserve(config.commands + 1);
+    double spawnRatio = config.commands > 0 ? (double)config.processes / config.commands : 0;
+    int pid = 1;
+    for (long long i = 0; i < config.commands; i++)
+    {
+        if (pid <= config.processes && i * spawnRatio >= pid - 1) // Spawn on schedule so every process is created
+        {
+            int run = config.runDist == 'e' ? 1 + (int)exponentialRun(rng) : uniformRun(rng);
+            out.push_back("S " + to_string(pid++) + " " + to_string(operand(rng)) + " " + to_string(run));
+            continue;
+        }
+        double x = pick(rng);
+        if ((x -= config.blockRatio) < 0)
+        {
+            string block = "B " + to_string(resource(rng));
+            out.push_back(config.maxTimeout > 0 ? block + " 0 " + to_string(timeout(rng)) : block);
+        }
+        else if ((x -= config.unblockRatio) < 0)
+        {
+            out.push_back("U " + to_string(resource(rng)));
+        }
+        else if ((x -= config.cRatio) < 0)
+        {
+            out.push_back(string("C ") + ops[cOp(rng)] + " " + to_string(operand(rng)));
+        }
+        else if ((x -= config.reportRatio) < 0)
+        {
+            out.push_back("P");
+        }
+        else
+        {
+            int n = ticks(rng);
+            out.push_back(n == 1 ? "Q" : "Q " + to_string(n));
+        }
+    }
+    if (config.terminate)
+    {
+        out.push_back("T");
+    }
+    return out;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+    Description:
+        Synthetic workload generator. Writes a command stream for commander / processManager to standard output.
+        Usage: workload_gen [-n commands] [-p processes] [-r u:min:max | e:mean] [-b block_ratio] [-u unblock_ratio]
+                            [-c c_ratio] [-m A:S:M:D] [-P report_ratio] [-k resources] [-t max_timeout] [-q max_ticks] [-s seed]
+        e.g. workload_gen -n 1000000 -p 20000 -r e:30 -b 0.1 -u 0.1 -m 4:2:1:1 | ./commander > out.txt
+*/
+
+//====| STL Includes |====//
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+//====| Local Includes |====//
+#include "workload.h"
+
+//====| Namespace |====//
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    WorkloadConfig config;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:p:r:b:u:c:m:P:k:t:q:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            config.commands = atoll(optarg);
+            break;
+        case 'p':
+            config.processes = atoi(optarg);
+            break;
+        case 'r':
+            config.runDist = optarg[0];
+            if (config.runDist == 'e')
+            {
+                sscanf(optarg, "e:%lf", &config.meanRun);
+            }
+            else
+            {
+                sscanf(optarg, "u:%d:%d", &config.minRun, &config.maxRun);
+            }
+            break;
+        case 'b':
+            config.blockRatio = atof(optarg);
+            break;
+        case 'u':
+            config.unblockRatio = atof(optarg);
+            break;
+        case 'c':
+            config.cRatio = atof(optarg);
+            break;
+        case 'm':
+            sscanf(optarg, "%d:%d:%d:%d", &config.cMix[0], &config.cMix[1], &config.cMix[2], &config.cMix[3]);
+            break;
+        case 'P':
+            config.reportRatio = atof(optarg);
+            break;
+        case 'k':
+            config.resources = atoi(optarg);
+            break;
+        case 't':
+            config.maxTimeout = atoi(optarg);
+            break;
+        case 'q':
+            config.maxTicks = atoi(optarg);
+            break;
+        case 's':
+            config.seed = atoi(optarg);
+            break;
+        default:
+            cerr << "usage: " << argv[0] << " [-n commands] [-p processes] [-r u:min:max | e:mean] [-b block_ratio] [-u unblock_ratio]"
+                 << " [-c c_ratio] [-m A:S:M:D] [-P report_ratio] [-k resources] [-t max_timeout] [-q max_ticks] [-s seed]" << endl;
+            exit(1);
+        }
+    }
+    for (const string &line : generateWorkload(config))
+    {
+        fputs(line.c_str(), stdout);
+        fputc('\n', stdout);
+    }
+    return 0;
+}
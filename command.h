@@ -0,0 +1,263 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+/*
+    Framed binary command format shared by commander and processManager.
+    Every command is one fixed-size Command record, so the reader can pull a large chunk
+    off the pipe and decode many commands per read() instead of one byte per syscall.
+*/
+//====| STL Includes |====//
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define COMMAND_BATCH 4096 // Records buffered per read()/write()
+#define END_OF_STREAM 0    // Command op a command source hands out once every producer is gone
+#define TICK 't'           // Command op of a wall-clock quantum tick (processManager -t); never parsed from text
+
+//====| Record |====//
+/*
+    op holds the command letter (S, B, U, Q, C, P, T, I, K).
+    S: arg = {pid, value, run_time}.  B/U: arg[0] = rid.  C: cop = A/S/M/D, arg[0] = value.
+    B/U/C: arg[1] = core, or -1 if none was given.  B: arg[2] = timeout in ticks, 0 for none.
+    Q: arg[0] = number of ticks (1 for a plain Q).
+    TICK: arg[0] = timer periods elapsed, arg[1] = sequence number of the last one (see tick_clock.h).
+*/
+struct Command
+{
+    char op;
+    char cop;
+    char pad[2];
+    int arg[3];
+};
+static_assert(sizeof(Command) == 16, "Command records must stay 16 bytes");
+
+//====| Command Table |====//
+/*
+    Text syntax of each command: the op letter, then (C only) one of A/S/M/D, then between minArgs and
+    maxArgs non-negative integers. Arguments left out take their defaults.
+*/
+struct CommandSyntax
+{
+    char op;
+    int minArgs;
+    int maxArgs;
+    int defaults[3];
+};
+
+constexpr CommandSyntax COMMAND_TABLE[] = {
+    {'S', 3, 3, {0, 0, 0}},  // S pid value run_time
+    {'B', 1, 3, {0, -1, 0}}, // B rid [core [timeout]]
+    {'U', 1, 2, {0, -1, 0}}, // U rid [core]
+    {'C', 1, 2, {0, -1, 0}}, // C op value [core]
+    {'Q', 0, 1, {1, 0, 0}},  // Q [ticks]
+    {'P', 0, 0, {0, 0, 0}},
+    {'T', 0, 0, {0, 0, 0}},
+    {'I', 0, 0, {0, 0, 0}},
+    {'K', 0, 0, {0, 0, 0}},
+};
+
+/*
+    Syntax of op, or NULL if op is not a command.
+*/
+constexpr const CommandSyntax *findSyntax(char op)
+{
+    for (const CommandSyntax &syntax : COMMAND_TABLE)
+    {
+        if (syntax.op == op)
+        {
+            return &syntax;
+        }
+    }
+    return NULL;
+}
+
+//====| Function Definitions |====//
+
+/*
+    Returns the next space-separated token of input from pos on (empty at the end) and moves pos past it.
+*/
+inline string_view nextToken(string_view input, size_t &pos)
+{
+    while (pos < input.size() && (input[pos] == ' ' || input[pos] == '\t' || input[pos] == '\r'))
+    {
+        pos++;
+    }
+    size_t begin = pos;
+    while (pos < input.size() && input[pos] != ' ' && input[pos] != '\t' && input[pos] != '\r')
+    {
+        pos++;
+    }
+    return input.substr(begin, pos - begin);
+}
+
+/*
+    Parses and validates a text command into cmd in one pass, without allocating: the line is only
+    looked at through string_views and the numbers are read with from_chars.
+    Returns false, leaving cmd unspecified, unless the command is known and every argument is a
+    non-negative integer that fits an int, in the number its syntax allows.
+*/
+inline bool parseCommand(string_view input, Command &cmd)
+{
+    memset(&cmd, 0, sizeof(cmd));
+    size_t pos = 0;
+    string_view token = nextToken(input, pos);
+    const CommandSyntax *syntax = token.size() == 1 ? findSyntax(token[0]) : NULL;
+    if (syntax == NULL)
+    {
+        return false;
+    }
+    cmd.op = syntax->op;
+    if (cmd.op == 'C')
+    {
+        token = nextToken(input, pos);
+        if (token.size() != 1 || (token[0] != 'A' && token[0] != 'S' && token[0] != 'M' && token[0] != 'D'))
+        {
+            return false;
+        }
+        cmd.cop = token[0];
+    }
+    int count = 0;
+    while (!(token = nextToken(input, pos)).empty())
+    {
+        if (count == syntax->maxArgs || token[0] < '0' || token[0] > '9')
+        {
+            return false;
+        }
+        from_chars_result result = from_chars(token.data(), token.data() + token.size(), cmd.arg[count]);
+        if (result.ec != errc() || result.ptr != token.data() + token.size())
+        {
+            return false;
+        }
+        count++;
+    }
+    if (count < syntax->minArgs)
+    {
+        return false;
+    }
+    for (; count < 3; count++)
+    {
+        cmd.arg[count] = syntax->defaults[count];
+    }
+    return true;
+}
+
+//====| Writer |====//
+/*
+    Buffers Command records and writes them out in batches.
+*/
+class CommandWriter
+{
+private:
+    int fd;
+    Command buffer[COMMAND_BATCH];
+    int count;
+
+public:
+    CommandWriter(int f) : fd(f), count(0) {}
+    ~CommandWriter() { flush(); }
+
+    /*
+        Appends cmd to the batch, writing the batch out first if it is full.
+    */
+    bool push(const Command &cmd)
+    {
+        if (count == COMMAND_BATCH && !flush())
+        {
+            return false;
+        }
+        buffer[count++] = cmd;
+        return true;
+    }
+
+    /*
+        Writes every buffered record. Returns false if the pipe is closed or write() fails.
+    */
+    bool flush()
+    {
+        const char *data = (const char *)buffer;
+        size_t left = count * sizeof(Command);
+        while (left > 0)
+        {
+            ssize_t n = write(fd, data, left);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            data += n;
+            left -= n;
+        }
+        count = 0;
+        return true;
+    }
+};
+
+//====| Reader |====//
+/*
+    Reads Command records in large chunks and hands them out one at a time.
+    A record split across two reads is carried over to the next chunk.
+*/
+class CommandReader
+{
+private:
+    int fd;
+    Command buffer[COMMAND_BATCH];
+    size_t bytes; // Bytes currently held in buffer
+    size_t next;  // Index of the next record to hand out
+
+public:
+    CommandReader(int f) : fd(f), bytes(0), next(0) {}
+
+    /*
+        Stores the next command in cmd. Returns false at end of stream.
+    */
+    bool read(Command &cmd)
+    {
+        if ((next + 1) * sizeof(Command) > bytes && !fill())
+        {
+            return false;
+        }
+        cmd = buffer[next++];
+        return true;
+    }
+
+private:
+    /*
+        Moves any partial record to the front of the buffer and reads until at least one whole record is held.
+    */
+    bool fill()
+    {
+        size_t used = next * sizeof(Command);
+        size_t partial = bytes - used;
+        memmove(buffer, (char *)buffer + used, partial);
+        bytes = partial;
+        next = 0;
+        while (bytes < sizeof(Command))
+        {
+            ssize_t n = ::read(fd, (char *)buffer + bytes, sizeof(buffer) - bytes);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            bytes += n;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -4,6 +4,14 @@
     Last Updated: 9/25/2024
     Description:
         This is the commander program that will take in input from the user and pass them to the process manager.
+        By default commands are streamed as fast as the process manager consumes them (the pipe provides the backpressure).
+        Records are batched only while more input is already buffered: whenever the commander would have to wait
+        for standard input, and after every P, I, K and T, what it holds is sent, so typed commands answer at once.
+        Usage: commander [-r commands_per_second] [-s socket_path | -m] [-- processManager options]
+            -r  rate-limited replay, e.g. -r 0.5 sends one command every two seconds
+            -s  feed an already running process manager listening on socket_path instead of spawning one
+            -m  send commands to the spawned process manager through a shared-memory ring instead of a pipe
+            Anything after -- is passed on to processManager (e.g. -- -n 4 to simulate 4 cores).
 */
 
 //====| STL Includes | ====//
@@ -13,7 +21,14 @@
 #include <unistd.h>
 #include <vector>
 #include <iomanip>
+#include <time.h>
+#include <cstring>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 //====| Local Includes |====//
+#include "command.h"
+#include "shm_ring.h"
 
 //====| Namespace |====//
 using namespace std;
@@ -21,17 +36,65 @@ using namespace std;
 //====| Globals Variables |====//
 #define READ_END 0
 #define WRITE_END 1
+#define INPUT_BUFFER (1 << 16) // Bytes of standard input read at a time (several thousand commands)
 
 //====| Function Declarations |====//
-bool is_digit(string);
-bool validateInput(string);
+long long nowNanos();
+void sleepUntil(long long);
+template <class Writer>
+int sendCommands(Writer &, double);
+int connectTo(const char *);
+int runShared(int, char *[], double);
+
+ShmRing *sharedRing = NULL; // Ring to the process manager with -m, closed if the manager exits
 
 //====| Main Program|====//
 int main(int argc, char *argv[])
 {
 
-    int c1, mcpipe1[2], status;
+    int c1, mcpipe1[2], status, opt;
     char mc0[10], mc1[10];
+    double rate = 0; // Commands per second in replay mode; 0 streams at full speed
+    const char *socketPath = NULL;
+    bool shared = false;
+    static char input[INPUT_BUFFER];
+
+    ios::sync_with_stdio(false);                  // cin gets its own buffer, so in_avail() tells if input is waiting
+    cin.rdbuf()->pubsetbuf(input, sizeof(input)); // Before the first read
+    while ((opt = getopt(argc, argv, "r:s:m")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            rate = atof(optarg);
+            break;
+        case 's':
+            socketPath = optarg;
+            break;
+        case 'm':
+            shared = true;
+            break;
+        default:
+            cerr << "usage: " << argv[0] << " [-r commands_per_second] [-s socket_path | -m] [-- processManager options]" << endl;
+            exit(1);
+        }
+    }
+
+    if (socketPath != NULL) // Another front end for a running process manager
+    {
+        int fd = connectTo(socketPath);
+        int result;
+        {
+            CommandWriter writer(fd);
+            result = sendCommands(writer, rate);
+        }
+        close(fd);
+        return result;
+    }
+    if (shared)
+    {
+        return runShared(argc, argv, rate);
+    }
 
     if (c1 = pipe(mcpipe1)) /* Create a pipe for master and a child process */
     {
@@ -49,7 +112,13 @@ int main(int argc, char *argv[])
     }
     else if (c1 == 0)
     {
-        execl("processManager", "processManager", mc0, mc1, NULL);
+        vector<char *> args = {(char *)"processManager", mc0, mc1};
+        for (int i = optind; i < argc; i++) // Forward processManager options
+        {
+            args.push_back(argv[i]);
+        }
+        args.push_back(NULL);
+        execv("processManager", args.data());
         exit(1);
     }
     else
@@ -57,25 +126,11 @@ int main(int argc, char *argv[])
         // Parent Here
         close(mcpipe1[READ_END]); // don't need this. . .
 
-        string line;
-        while (getline(cin, line))
+        CommandWriter writer(mcpipe1[WRITE_END]);
+        if (sendCommands(writer, rate))
         {
-            if (validateInput(line))
-            {
-                write(mcpipe1[WRITE_END], line.c_str(), line.size() + 1);
-                if (line[0] == 'T')
-                {
-                    break;
-                }
-            }
-            else
-            {
-                cout << "ERROR: " << line << endl;
-                perror("Incorrect Command");
-                return 1;
-            }
-            sleep(2);
-        };
+            return 1;
+        }
     }
     wait(&status);
     // cout << "Child status is " << WEXITSTATUS(status) << endl;
@@ -84,42 +139,132 @@ int main(int argc, char *argv[])
 
 //====| Function Definitions |====//
 
-bool is_digit(string input)
+/*
+    Spawns the process manager with a shared-memory command ring (memfd) instead of a pipe, and streams
+    the commands through it. The ring is closed when the input ends, or as soon as the manager exits,
+    so neither side can be left waiting on the other.
+*/
+int runShared(int argc, char *argv[], double rate)
 {
-    for (char ch : input)
+    int fd, status;
+    sharedRing = ShmRing::create(fd);
+    if (sharedRing == NULL)
     {
-        if (!isdigit(ch))
+        exit(1);
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = [](int)
+    { sharedRing->close(); };
+    sigaction(SIGCHLD, &action, NULL);
+
+    pid_t child = fork();
+    if (child == -1)
+    {
+        perror("unable to fork child");
+        exit(1);
+    }
+    if (child == 0)
+    {
+        string ringFd = to_string(fd);
+        vector<char *> args = {(char *)"processManager", (char *)"-1", (char *)"-1", (char *)"-m", (char *)ringFd.c_str()};
+        for (int i = optind; i < argc; i++) // Forward processManager options
         {
-            return false;
+            args.push_back(argv[i]);
         }
+        args.push_back(NULL);
+        execv("processManager", args.data());
+        exit(1);
     }
-    return true;
+    int result = sendCommands(*sharedRing, rate);
+    sharedRing->close();
+    waitpid(child, &status, 0);
+    return result;
 }
 
-bool validateInput(string input)
+/*
+    Validates every line of standard input and sends it to writer (a CommandWriter or ShmRing), until T
+    or end of input. Records are flushed once no more input is buffered (the next read may block, e.g. on
+    a person typing) and after commands someone waits on the output of; in between they are batched.
+    Returns 1 on the first invalid command, or if the process manager has gone away.
+*/
+template <class Writer>
+int sendCommands(Writer &writer, double rate)
 {
-    istringstream iss(input);
-    string s;
-    vector<string> args = vector<string>();
-    while (getline(iss, s, ' '))
+    Command cmd;
+    string line;
+    long long interval = rate > 0 ? (long long)(1e9 / rate) : 0;
+    long long next = nowNanos() + interval;
+    while (getline(cin, line))
     {
-        args.push_back(s);
+        if (parseCommand(line, cmd))
+        {
+            if (!writer.push(cmd)) // Blocks once the pipe/ring is full, so we never run ahead of the manager
+            {
+                return 1;
+            }
+            bool reply = cmd.op == 'P' || cmd.op == 'I' || cmd.op == 'K' || cmd.op == 'T';
+            if ((interval > 0 || reply || cin.rdbuf()->in_avail() <= 0) && !writer.flush())
+            {
+                return 1;
+            }
+            if (interval > 0) // Replay mode: send now, then wait for the next slot
+            {
+                sleepUntil(next);
+                next += interval;
+            }
+            if (cmd.op == 'T')
+            {
+                break;
+            }
+        }
+        else
+        {
+            cout << "ERROR: " << line << endl;
+            perror("Incorrect Command");
+            return 1;
+        }
+    };
+    return 0;
+}
+
+/*
+    Connects to a process manager's Unix socket.
+*/
+int connectTo(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+    {
+        perror("unable to connect to the process manager");
+        exit(1);
     }
-    switch (args[0][0])
+    return fd;
+}
+
+/*
+    Monotonic clock in nanoseconds.
+*/
+long long nowNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+    Sleeps until the absolute monotonic deadline, so pacing does not drift with the time spent sending.
+*/
+void sleepUntil(long long deadline)
+{
+    struct timespec ts;
+    ts.tv_sec = deadline / 1000000000LL;
+    ts.tv_nsec = deadline % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
     {
-    case 'S':
-        return (is_digit(args[1]) && is_digit(args[2]) && is_digit(args[3]) && args.size() == 4);
-    case 'B':
-        return is_digit(args[1]) && args.size() == 2;
-    case 'U':
-        return is_digit(args[1]) && args.size() == 2;
-    case 'C':
-        return (args[1] == "A" || args[1] == "S" || args[1] == "M" || args[1] == "D") && is_digit(args[2]) && args.size() == 3;
-    case 'Q':
-    case 'P':
-    case 'T':
-        return args.size() == 1;
-    default:
-        return false;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,173 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+/*
+    Binary scheduling event trace (processManager -j file, read back with traceView).
+    The scheduler records one 16-byte TraceEvent per process start, dispatch, preemption, completion,
+    block and unblock into a fixed-size single-producer / single-consumer ring, and a flusher thread
+    drains the ring to the file in large writes. Recording is a store into a preallocated cell and one
+    release store of the tail: no allocation, lock or system call. If the flusher falls a whole ring
+    behind, the scheduler yields until there is room rather than dropping events, since a trace with
+    holes cannot be replayed.
+    The file is a TraceHeader followed by the events in the order they happened.
+*/
+//====| STL Includes |====//
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define TRACE_MAGIC 0x3145434152544D50ULL // "PMTRACE1"
+#define TRACE_VERSION 1
+#define TRACE_RING (1 << 16)              // Events the ring holds (1 MB)
+#define TRACE_IDLE_SLEEP 1                // Milliseconds the flusher sleeps when the ring is empty
+
+//====| Trace Records |====//
+
+/*
+    What happened. The values are the letters traceView prints.
+*/
+enum TraceKind : unsigned char
+{
+    TRACE_START = 'S',    // pid was created (arg: run time)
+    TRACE_DISPATCH = 'R', // pid starts running on core; pid < 1 means the core goes idle (arg: quantum)
+    TRACE_PREEMPT = 'Q',  // pid used up its quantum on core and went back to a ready queue
+    TRACE_EXIT = 'F',     // pid finished on core (arg: turnaround)
+    TRACE_BLOCK = 'B',    // pid blocked on resource arg, leaving core
+    TRACE_UNBLOCK = 'U',  // pid was unblocked from resource arg by U toward core (-1: any)
+    TRACE_TIMEOUT = 'W',  // pid's block on resource arg timed out
+};
+
+struct TraceEvent
+{
+    int time;
+    int pid;
+    int arg;
+    short core;
+    unsigned char kind;  // TraceKind
+    unsigned char level; // Priority level of pid at the time
+};
+
+struct TraceHeader
+{
+    unsigned long long magic;
+    int version;
+    int eventSize; // sizeof(TraceEvent)
+    int cores;
+    int levels;
+    char policy[16];
+};
+
+//====| Class Declaration |====//
+class EventTrace
+{
+private:
+    TraceEvent *events;
+    size_t mask;
+    alignas(64) atomic<size_t> tail; // Next event the scheduler records
+    alignas(64) atomic<size_t> head; // Next event the flusher writes
+    atomic<bool> stopping;
+    FILE *file;
+    bool ok;
+    thread flusher;
+
+    void flush(); // Flusher thread body
+
+public:
+    //----| Constructor(s) |----//
+    EventTrace(const string &path, const char *policy, int cores, int levels, size_t capacity = TRACE_RING);
+    ~EventTrace(); // Writes out every recorded event and closes the file
+
+    bool good() const { return ok; }
+
+    /*
+        Appends one event; called by the scheduler thread only.
+    */
+    void record(int time, TraceKind kind, int core, int pid, int arg, int level)
+    {
+        size_t pos = tail.load(memory_order_relaxed);
+        while (pos - head.load(memory_order_acquire) > mask) // Full: wait for the flusher
+        {
+            this_thread::yield();
+        }
+        events[pos & mask] = TraceEvent{time, pid, arg, (short)core, kind, (unsigned char)level};
+        tail.store(pos + 1, memory_order_release);
+    }
+};
+
+//====| Class Definitions |====//
+
+inline EventTrace::EventTrace(const string &path, const char *policy, int cores, int levels, size_t capacity)
+    : tail(0), head(0), stopping(false)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    events = new TraceEvent[size];
+    mask = size - 1;
+
+    file = fopen(path.c_str(), "wb");
+    ok = file != NULL;
+    if (ok)
+    {
+        setvbuf(file, NULL, _IOFBF, 1 << 20);
+        TraceHeader header = {TRACE_MAGIC, TRACE_VERSION, (int)sizeof(TraceEvent), cores, levels, {0}};
+        strncpy(header.policy, policy, sizeof(header.policy) - 1);
+        ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+    flusher = thread(&EventTrace::flush, this);
+}
+
+inline EventTrace::~EventTrace()
+{
+    stopping.store(true, memory_order_release);
+    flusher.join();
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    delete[] events;
+}
+
+/*
+    Writes whatever the scheduler has recorded, one contiguous run of the ring at a time, and sleeps
+    briefly when there is nothing new. Once stopping is set no more events are coming, so the ring is
+    drained one last time before returning.
+*/
+inline void EventTrace::flush()
+{
+    while (true)
+    {
+        size_t from = head.load(memory_order_relaxed);
+        size_t to = tail.load(memory_order_acquire);
+        if (from == to)
+        {
+            if (stopping.load(memory_order_acquire))
+            {
+                if (tail.load(memory_order_acquire) == from)
+                {
+                    return;
+                }
+                continue;
+            }
+            this_thread::sleep_for(chrono::milliseconds(TRACE_IDLE_SLEEP));
+            continue;
+        }
+        size_t begin = from & mask;
+        size_t count = min(to - from, mask + 1 - begin); // Up to the end of the array; the rest next time
+        if (ok && fwrite(events + begin, sizeof(TraceEvent), count, file) != count)
+        {
+            ok = false;
+        }
+        head.store(from + count, memory_order_release);
+    }
+}
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+/*
+    Binary checkpoint images.
+    ImageWriter appends raw values and arrays to a file through a large stdio buffer; ImageReader reads them
+    back from a read-only mmap of the file with bounds checks, so restoring is mostly memcpy out of the page cache.
+    Arrays are stored as a 64-bit element count followed by the elements. Only trivially copyable types are
+    written this way; each structure saves and loads its own fields (see the save/load methods).
+*/
+//====| STL Includes |====//
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define IMAGE_BUFFER (1 << 20) // stdio buffer of the writer
+
+//====| Writer |====//
+/*
+    Writes an image to path + ".tmp" and renames it over path on close, so a crash mid-write never
+    leaves a torn image behind.
+*/
+class ImageWriter
+{
+private:
+    string path;
+    FILE *file;
+    bool good;
+
+public:
+    ImageWriter(const string &p) : path(p), good(true)
+    {
+        file = fopen((path + ".tmp").c_str(), "wb");
+        good = file != NULL;
+        if (good)
+        {
+            setvbuf(file, NULL, _IOFBF, IMAGE_BUFFER);
+        }
+    }
+    ~ImageWriter()
+    {
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+    }
+
+    void bytes(const void *data, size_t size)
+    {
+        if (good && size > 0 && fwrite(data, 1, size, file) != size)
+        {
+            good = false;
+        }
+    }
+    template <class T>
+    void value(const T &v)
+    {
+        bytes(&v, sizeof(T));
+    }
+    template <class T>
+    void array(const T *data, unsigned long long count)
+    {
+        value(count);
+        bytes(data, count * sizeof(T));
+    }
+    template <class T>
+    void array(const vector<T> &v)
+    {
+        array(v.data(), v.size());
+    }
+
+    /*
+        Flushes the image and moves it into place. Returns false if anything failed along the way.
+    */
+    bool close()
+    {
+        if (file == NULL)
+        {
+            return false;
+        }
+        good = fclose(file) == 0 && good;
+        file = NULL;
+        if (good)
+        {
+            good = rename((path + ".tmp").c_str(), path.c_str()) == 0;
+        }
+        else
+        {
+            unlink((path + ".tmp").c_str());
+        }
+        return good;
+    }
+};
+
+//====| Reader |====//
+/*
+    Maps an image read-only. Every read is checked against the mapped size; after the first short read
+    good() is false and later reads return zeroes.
+*/
+class ImageReader
+{
+private:
+    const char *data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+public:
+    ImageReader(const string &path) : data(NULL), size(0), pos(0), ok(false)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (map != MAP_FAILED)
+            {
+                data = (const char *)map;
+                size = st.st_size;
+                ok = true;
+            }
+        }
+        ::close(fd);
+    }
+    ~ImageReader()
+    {
+        if (data != NULL)
+        {
+            munmap((void *)data, size);
+        }
+    }
+
+    bool good() const { return ok; }
+    bool atEnd() const { return pos == size; }
+
+    void bytes(void *out, size_t n)
+    {
+        if (!ok || n > size - pos)
+        {
+            ok = false;
+            memset(out, 0, n);
+            return;
+        }
+        memcpy(out, data + pos, n);
+        pos += n;
+    }
+    template <class T>
+    void value(T &v)
+    {
+        bytes(&v, sizeof(T));
+    }
+    /*
+        Reads an array written by ImageWriter::array into out, which must have room for at most max elements.
+        Returns the element count (0 on error).
+    */
+    template <class T>
+    unsigned long long array(T *out, unsigned long long max)
+    {
+        unsigned long long count = 0;
+        value(count);
+        if (count > max)
+        {
+            ok = false;
+            return 0;
+        }
+        bytes(out, count * sizeof(T));
+        return ok ? count : 0;
+    }
+    template <class T>
+    void array(vector<T> &v)
+    {
+        unsigned long long count = 0;
+        value(count);
+        if (!ok || count > (size - pos) / sizeof(T))
+        {
+            ok = false;
+            v.clear();
+            return;
+        }
+        v.resize(count);
+        bytes(v.data(), count * sizeof(T));
+    }
+};
+
+#endif
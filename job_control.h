@@ -0,0 +1,233 @@
+#ifndef JOB_CONTROL_H
+#define JOB_CONTROL_H
+/*
+    Real-process execution mode (processManager -x command).
+    Every S launches command through /bin/sh as a child in its own process group, stopped before it runs,
+    with PM_PID, PM_VALUE and PM_RUNTIME in its environment. From then on the simulated schedule is enforced
+    on the real jobs: when a core's running process changes, the one leaving the core is sent SIGSTOP and
+    the one taking it is pinned to that core's CPU with sched_setaffinity (cores beyond the machine's CPUs
+    wrap around) and sent SIGCONT. A process that uses up its run time has its job terminated. The CPU time
+    P shows for a process is the job's real CPU time in milliseconds, read from its CPU-time clock; use
+    "exec prog" in command so that clock belongs to prog rather than to the shell.
+    The cost of each switch (the signals and affinity calls made by the scheduler) is recorded for T.
+*/
+//====| STL Includes |====//
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+//====| Local Includes |====//
+#include "latency_histogram.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+extern char **environ;
+
+//====| Job Statistics |====//
+/*
+    What T reports about the real jobs (launched 0: not in real-process mode).
+*/
+struct JobStats
+{
+    unsigned long long launched = 0;
+    unsigned long long switches = 0; // Changes of a core's job
+    long long cpuMillis = 0;         // Real CPU time of the jobs that have finished
+    LatencyHistogram switchCost;     // Nanoseconds the scheduler spent stopping, pinning and continuing per switch
+};
+
+//====| Class Declaration |====//
+class JobControl
+{
+private:
+    /*
+        The job of one simulated process.
+    */
+    struct Job
+    {
+        pid_t child;      // Also its process group
+        clockid_t clock;  // CPU-time clock of the child
+        int cpu;          // CPU it is pinned to, -1 before its first run
+        long long millis; // Last CPU time read
+    };
+
+    string command;
+    int cpus;        // Online CPUs the cores map onto
+    int devNull;     // Standard input of the jobs, so they cannot read the manager's commands
+    unordered_map<int, Job> jobs; // Live jobs by simulated PID
+    JobStats stats;
+
+    static long long now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    long long readCPU(Job &job)
+    {
+        struct timespec ts;
+        if (clock_gettime(job.clock, &ts) == 0)
+        {
+            job.millis = ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+        }
+        return job.millis; // Gone already: the last reading
+    }
+
+    void reap()
+    {
+        while (waitpid(-1, NULL, WNOHANG) > 0)
+        {
+        }
+    }
+
+public:
+    //----| Constructor(s) |----//
+    JobControl(const string &cmd) : command(cmd)
+    {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus < 1)
+        {
+            cpus = 1;
+        }
+        devNull = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+    ~JobControl() // Kills whatever is still running
+    {
+        for (auto &entry : jobs)
+        {
+            kill(-entry.second.child, SIGKILL);
+        }
+        for (auto &entry : jobs)
+        {
+            waitpid(entry.second.child, NULL, 0);
+        }
+        reap();
+        if (devNull >= 0)
+        {
+            close(devNull);
+        }
+    }
+    JobControl(const JobControl &) = delete;
+    JobControl &operator=(const JobControl &) = delete;
+
+    /*
+        Starts the job of a new process, stopped. Returns false if it could not be started.
+    */
+    bool launch(int pid, int value, int runTime)
+    {
+        // Everything the child needs is built before fork: the manager has other threads, so the child
+        // may only make async-signal-safe calls until it execs
+        string vars[3] = {"PM_PID=" + to_string(pid), "PM_VALUE=" + to_string(value), "PM_RUNTIME=" + to_string(runTime)};
+        vector<char *> env;
+        for (char **e = environ; *e != NULL; e++)
+        {
+            env.push_back(*e);
+        }
+        for (string &var : vars)
+        {
+            env.push_back(&var[0]);
+        }
+        env.push_back(NULL);
+        const char *argv[] = {"sh", "-c", command.c_str(), NULL};
+
+        pid_t child = fork();
+        if (child < 0)
+        {
+            perror("unable to launch a job");
+            return false;
+        }
+        if (child == 0)
+        {
+            setpgid(0, 0);
+            if (devNull >= 0)
+            {
+                dup2(devNull, STDIN_FILENO);
+            }
+            raise(SIGSTOP); // Wait to be dispatched
+            execve("/bin/sh", (char *const *)argv, env.data());
+            _exit(127);
+        }
+        setpgid(child, child);
+        int status;
+        waitpid(child, &status, WUNTRACED); // Returns once it has stopped itself
+        Job job = {child, 0, -1, 0};
+        if (clock_getcpuclockid(child, &job.clock))
+        {
+            job.clock = CLOCK_PROCESS_CPUTIME_ID; // Should not happen for our own child; reads as 0 below
+            job.millis = 0;
+        }
+        jobs[pid] = job;
+        stats.launched++;
+        return true;
+    }
+
+    /*
+        core's running process changes from previous to next (either may be < 1 for none).
+    */
+    void dispatch(int core, int previous, int next)
+    {
+        long long start = now();
+        unordered_map<int, Job>::iterator it = jobs.find(previous);
+        if (it != jobs.end())
+        {
+            kill(-it->second.child, SIGSTOP);
+        }
+        it = jobs.find(next);
+        if (it != jobs.end())
+        {
+            Job &job = it->second;
+            int cpu = core % cpus;
+            if (job.cpu != cpu)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                sched_setaffinity(job.child, sizeof(set), &set);
+                job.cpu = cpu;
+            }
+            kill(-job.child, SIGCONT);
+        }
+        stats.switches++;
+        stats.switchCost.record(now() - start);
+    }
+
+    /*
+        The process has used up its run time: its job is terminated (continued so it can handle SIGTERM).
+    */
+    void finish(int pid)
+    {
+        unordered_map<int, Job>::iterator it = jobs.find(pid);
+        if (it == jobs.end())
+        {
+            return;
+        }
+        stats.cpuMillis += readCPU(it->second);
+        kill(-it->second.child, SIGTERM);
+        kill(-it->second.child, SIGCONT);
+        jobs.erase(it);
+        reap();
+    }
+
+    /*
+        Real CPU time of pid's job in milliseconds, or fallback if it has none.
+    */
+    int cpuMillis(int pid, int fallback)
+    {
+        unordered_map<int, Job>::iterator it = jobs.find(pid);
+        return it == jobs.end() ? fallback : (int)readCPU(it->second);
+    }
+
+    const JobStats &getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+/*
+    Streaming log-linear (HDR-style) histogram of non-negative integer times.
+    Values below 2 * HIST_SUB are counted exactly; above that every power of two is split into HIST_SUB
+    equal buckets, so a reported percentile is within 1/HIST_SUB (about 3%) of the true value.
+    Memory is fixed (HIST_BUCKETS counters) no matter how many values are recorded.
+*/
+//====| STL Includes |====//
+#include <cstring>
+
+//====| Globals Variables |====//
+#define HIST_SUB_BITS 5
+#define HIST_SUB (1 << HIST_SUB_BITS)         // Buckets per power of two
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS) * HIST_SUB) // Enough for any 63-bit value
+
+//====| Class Declaration |====//
+class LatencyHistogram
+{
+private:
+    unsigned long long buckets[HIST_BUCKETS];
+    unsigned long long total; // Values recorded
+    long long maxValue;
+
+    static int bucketOf(long long value);
+    static long long highestIn(int bucket); // Largest value that falls into bucket
+
+public:
+    //----| Constructor(s) |----//
+    LatencyHistogram() { clear(); }
+
+    //----| Setters |----//
+    void record(long long value);
+    void clear();
+
+    //----| Getters |----//
+    unsigned long long count() const { return total; }
+    long long max() const { return maxValue; }
+    long long percentile(double p) const; // Value at or below which a fraction p of the values fall; 0 if empty
+};
+
+//====| Class Definitions |====//
+
+inline void LatencyHistogram::record(long long value)
+{
+    if (value < 0)
+    {
+        value = 0;
+    }
+    buckets[bucketOf(value)]++;
+    total++;
+    if (value > maxValue)
+    {
+        maxValue = value;
+    }
+}
+
+inline void LatencyHistogram::clear()
+{
+    memset(buckets, 0, sizeof(buckets));
+    total = 0;
+    maxValue = 0;
+}
+
+/*
+    Walks the buckets until a fraction p of the values has been seen. The answer is the top of that
+    bucket, capped at the largest value recorded.
+*/
+inline long long LatencyHistogram::percentile(double p) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+    unsigned long long target = (unsigned long long)(p * total + 0.5);
+    if (target < 1)
+    {
+        target = 1;
+    }
+    unsigned long long seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++)
+    {
+        seen += buckets[b];
+        if (seen >= target)
+        {
+            return highestIn(b) < maxValue ? highestIn(b) : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+//----| Helpers |----//
+
+/*
+    Values below 2 * HIST_SUB map to themselves. A larger value keeps its top HIST_SUB_BITS + 1 bits:
+    with shift = msb - HIST_SUB_BITS, it goes to shift * HIST_SUB + (value >> shift).
+*/
+inline int LatencyHistogram::bucketOf(long long value)
+{
+    if (value < 2 * HIST_SUB)
+    {
+        return (int)value;
+    }
+    int shift = 63 - __builtin_clzll((unsigned long long)value) - HIST_SUB_BITS;
+    return shift * HIST_SUB + (int)(value >> shift);
+}
+
+inline long long LatencyHistogram::highestIn(int bucket)
+{
+    if (bucket < 2 * HIST_SUB)
+    {
+        return bucket;
+    }
+    int shift = bucket / HIST_SUB - 1;
+    long long low = (long long)(bucket - shift * HIST_SUB) << shift;
+    return low + (1LL << shift) - 1;
+}
+
+#endif
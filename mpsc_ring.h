@@ -0,0 +1,165 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+/*
+    Bounded lock-free multi-producer / single-consumer ring.
+    Every cell carries a sequence number (Vyukov's bounded queue): a producer claims a cell with one
+    compare-and-swap on tail and publishes it by bumping the cell's sequence, and the consumer needs no
+    atomic read-modify-write at all. Items from one producer come out in the order that producer pushed them.
+    The blocking push()/pop() only fall back to yielding (full) or a condition variable (empty).
+*/
+//====| STL Includes |====//
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Class Declaration |====//
+template <class T>
+class MPSCRing
+{
+private:
+    struct Cell
+    {
+        atomic<size_t> sequence; // pos while free for the producer at pos, pos + 1 once filled
+        T data;
+    };
+
+    Cell *cells;
+    size_t mask;
+    alignas(64) atomic<size_t> tail; // Next position a producer will claim
+    alignas(64) size_t head;         // Next position the consumer reads (consumer only)
+    atomic<bool> sleeping;           // Consumer is (about to be) waiting on wakeup
+    atomic<bool> closed;             // No more pops will happen; producers give up
+    mutex lock;
+    condition_variable wakeup;
+
+public:
+    //----| Constructor(s) |----//
+    MPSCRing(size_t capacity); // capacity is rounded up to a power of two
+    ~MPSCRing() { delete[] cells; }
+
+    //----| Producers |----//
+    bool tryPush(const T &item); // False if the ring is full
+    bool push(const T &item);    // Yields while full; false once the ring is closed
+
+    //----| Consumer |----//
+    bool tryPop(T &item); // False if the ring is empty
+    void pop(T &item);    // Sleeps while empty
+    void close();         // Wakes and releases producers blocked in push()
+};
+
+//====| Class Definitions |====//
+
+template <class T>
+MPSCRing<T>::MPSCRing(size_t capacity) : tail(0), head(0), sleeping(false), closed(false)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    cells = new Cell[size];
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++)
+    {
+        cells[i].sequence.store(i, memory_order_relaxed);
+    }
+}
+
+template <class T>
+bool MPSCRing<T>::tryPush(const T &item)
+{
+    size_t pos = tail.load(memory_order_relaxed);
+    Cell *cell;
+    while (true)
+    {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(memory_order_acquire);
+        ptrdiff_t dif = (ptrdiff_t)seq - (ptrdiff_t)pos;
+        if (dif == 0)
+        {
+            if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (dif < 0)
+        {
+            return false; // The consumer has not freed this cell yet: full
+        }
+        else
+        {
+            pos = tail.load(memory_order_relaxed); // Another producer took it
+        }
+    }
+    cell->data = item;
+    cell->sequence.store(pos + 1, memory_order_release);
+
+    atomic_thread_fence(memory_order_seq_cst); // Pairs with the fence in pop(): either we see sleeping or it sees the item
+    if (sleeping.load(memory_order_relaxed))
+    {
+        lock_guard<mutex> guard(lock);
+        wakeup.notify_one();
+    }
+    return true;
+}
+
+template <class T>
+bool MPSCRing<T>::push(const T &item)
+{
+    while (!tryPush(item))
+    {
+        if (closed.load(memory_order_acquire))
+        {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+template <class T>
+bool MPSCRing<T>::tryPop(T &item)
+{
+    Cell *cell = &cells[head & mask];
+    if (cell->sequence.load(memory_order_acquire) != head + 1)
+    {
+        return false;
+    }
+    item = cell->data;
+    cell->sequence.store(head + mask + 1, memory_order_release); // Free for the producer one lap later
+    head++;
+    return true;
+}
+
+template <class T>
+void MPSCRing<T>::pop(T &item)
+{
+    for (int spin = 0; spin < 1000; spin++)
+    {
+        if (tryPop(item))
+        {
+            return;
+        }
+    }
+    unique_lock<mutex> guard(lock);
+    sleeping.store(true, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!tryPop(item))
+    {
+        wakeup.wait(guard);
+    }
+    sleeping.store(false, memory_order_relaxed);
+}
+
+template <class T>
+void MPSCRing<T>::close()
+{
+    closed.store(true, memory_order_release);
+}
+
+#endif
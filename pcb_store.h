@@ -0,0 +1,515 @@
+#ifndef PCB_STORE_H
+#define PCB_STORE_H
+/*
+    Growable slab of PCBs.
+    PCBs live in fixed-size structure-of-arrays chunks that are never moved, so a PCB's address stays valid until it is retired.
+    Retired slots are reused through a free list, and every slot carries a generation that is bumped on
+    retire, so a stale PCBHandle is detected instead of silently reading another process.
+    Arbitrary 32-bit PIDs are mapped to slots through a flat open-addressing (linear probing) hash index.
+*/
+//====| STL Includes |====//
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+//====| Local Includes |====//
+#include "PCB.h"
+#include "image.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define PCB_CHUNK_BITS 12                  // 4096 PCBs per chunk
+#define PCB_CHUNK (1 << PCB_CHUNK_BITS)
+#define PCB_NO_SLOT 0xFFFFFFFFu            // Marks an empty index bucket / invalid handle
+
+//====| Handle |====//
+struct PCBHandle
+{
+    unsigned int slot;
+    unsigned int generation;
+};
+
+//====| Chunk |====//
+/*
+    Structure-of-arrays storage for PCB_CHUNK PCBs. Each field is its own cache-line aligned column,
+    so a pass that only needs cpu_time and run_time never pulls value or start_time into cache,
+    and loops over a column vectorize.
+*/
+struct PCBChunk
+{
+    alignas(64) int pid[PCB_CHUNK];
+    alignas(64) int priority[PCB_CHUNK];
+    alignas(64) int value[PCB_CHUNK];
+    alignas(64) int start_time[PCB_CHUNK];
+    alignas(64) int run_time[PCB_CHUNK];
+    alignas(64) int cpu_time[PCB_CHUNK];
+    alignas(64) int ready_since[PCB_CHUNK];
+    alignas(64) int wait_time[PCB_CHUNK];
+    alignas(64) int response_time[PCB_CHUNK];
+    alignas(64) int live[PCB_CHUNK];                // 1 while the slot holds a PCB, 0 otherwise
+    alignas(64) unsigned int generation[PCB_CHUNK]; // Bumped every time the slot is retired
+    alignas(64) unsigned int nextFree[PCB_CHUNK];   // Next slot in the free list while this one is free
+};
+
+//====| Reference |====//
+/*
+    Reference to one PCB inside a chunk. Offers the same interface as PCB.
+    A reference to the placeholder (slot 0, never live) is read-only: its setters do nothing and it never finishes.
+*/
+class PCBRef
+{
+private:
+    PCBChunk *c;
+    int i;
+
+public:
+    PCBRef(PCBChunk *chunk, int index) : c(chunk), i(index) {}
+
+    //----| Getters |----//
+    int getPID() const { return c->pid[i]; }
+    int getPriority() const { return c->priority[i]; }
+    int getValue() const { return c->value[i]; }
+    int getStart() const { return c->start_time[i]; }
+    int getRun() const { return c->run_time[i]; }
+    int getCPU() const { return c->cpu_time[i]; }
+    int getReadySince() const { return c->ready_since[i]; }
+    int getWait() const { return c->wait_time[i]; }
+    int getResponse() const { return c->response_time[i]; }
+    bool isLive() const { return c->live[i]; }
+
+    //----| Setters |----//
+    void setValue(int val)
+    {
+        if (isLive())
+        {
+            c->value[i] = val;
+        }
+    }
+    void setPriority(int level)
+    {
+        if (isLive())
+        {
+            c->priority[i] = level;
+        }
+    }
+    void incrementPriority()
+    {
+        if (isLive() && c->priority[i] < 3)
+        {
+            c->priority[i]++;
+        }
+    }
+    void decrementPriority()
+    {
+        if (isLive() && c->priority[i] > 0)
+        {
+            c->priority[i]--;
+        }
+    }
+    void setReady(int Time)
+    {
+        if (isLive())
+        {
+            c->ready_since[i] = Time;
+        }
+    }
+    void dispatch(int Time)
+    {
+        if (!isLive())
+        {
+            return;
+        }
+        c->wait_time[i] += Time - c->ready_since[i];
+        if (c->response_time[i] < 0)
+        {
+            c->response_time[i] = Time - c->start_time[i];
+        }
+    }
+    bool incrementTime()
+    {
+        return addTime(1);
+    }
+    bool addTime(int ticks)
+    {
+        if (!isLive())
+        {
+            return false;
+        }
+        c->cpu_time[i] += ticks;
+        return c->cpu_time[i] >= c->run_time[i];
+    }
+
+    //----| Helpers |----//
+    friend ostream &operator<<(ostream &out, const PCBRef &pcb)
+    {
+        return printPCB(out, pcb.getPID(), pcb.getPriority(), pcb.getValue(), pcb.getStart(), pcb.getCPU());
+    }
+};
+
+//====| Class Declaration |====//
+class PCBStore
+{
+private:
+    PCBChunk **chunks;     // Chunk pointers; only this table is reallocated when growing
+    int chunkCount;        // Chunks allocated
+    int chunkCapacity;     // Size of chunks
+    unsigned int used;     // Slots handed out at least once (high-water mark)
+    unsigned int freeHead; // First slot of the free list
+    int liveCount;         // PCBs currently stored
+
+    int *keys;             // Index bucket -> PID
+    unsigned int *slots;   // Index bucket -> slot, PCB_NO_SLOT if the bucket is empty
+
+    unsigned int capacity; // Number of buckets (power of two)
+
+    PCBChunk *chunkOf(unsigned int slot) const { return chunks[slot >> PCB_CHUNK_BITS]; }
+    int offsetOf(unsigned int slot) const { return slot & (PCB_CHUNK - 1); }
+    int chunkUsed(int chunk) const; // Slots of chunk that have ever been handed out
+    unsigned int bucket(int pid) const { return ((unsigned int)pid * 2654435761u) & (capacity - 1); }
+    unsigned int indexFind(int pid) const;
+    void indexInsert(int pid, unsigned int slot);
+    void indexErase(int pid);
+    void indexGrow();
+    unsigned int allocate();
+
+public:
+    //----| Constructor(s) |----//
+    PCBStore();
+    ~PCBStore();
+
+    //----| Setters |----//
+    PCBHandle insert(const PCB &pcb); // Stores pcb under its PID, replacing a live PCB with the same PID
+    bool retire(PCBHandle h);         // Frees the slot; false if h is stale
+
+    //----| Getters |----//
+    PCBHandle find(int pid) const;    // Handle for pid; slot is PCB_NO_SLOT if pid is not stored
+    bool valid(PCBHandle h) const;    // False if h is stale
+    PCBRef get(PCBHandle h);          // PCB for h; the zeroed placeholder PCB if h is stale
+    PCBRef operator[](int pid);       // PCB for pid; the zeroed placeholder PCB if pid is not stored
+    int size() const { return liveCount; }
+
+    //----| Columns |----//
+    template <class Pass>
+    void forEachChunk(Pass pass);     // Calls pass(chunk, slots used) for every chunk; for column-wise passes
+
+    //----| Checkpoint |----//
+    void save(ImageWriter &) const;   // Chunks, free list and index, as they are in memory
+    bool load(ImageReader &);         // Replaces the whole store with a saved one
+};
+
+//====| Class Definitions |====//
+
+//----| Constructor(s) |----//
+
+/*
+    Slot 0 is reserved as the zeroed placeholder PCB; it is never indexed, handed out or live.
+*/
+inline PCBStore::PCBStore() : chunks(NULL), chunkCount(0), chunkCapacity(0), used(0), freeHead(PCB_NO_SLOT),
+                       liveCount(0), capacity(1024)
+{
+    keys = new int[capacity];
+    slots = new unsigned int[capacity];
+    memset(slots, 0xFF, capacity * sizeof(unsigned int));
+    allocate();
+}
+
+inline PCBStore::~PCBStore()
+{
+    for (int i = 0; i < chunkCount; i++)
+    {
+        delete chunks[i];
+    }
+    free(chunks);
+    delete[] keys;
+    delete[] slots;
+}
+
+//----| Setters |----//
+
+/*
+    Stores pcb under its PID. A live PCB with the same PID is overwritten in place (same handle);
+    otherwise a slot is taken from the free list, or from a new chunk if the free list is empty.
+*/
+inline PCBHandle PCBStore::insert(const PCB &pcb)
+{
+    int pid = pcb.getPID();
+    unsigned int slot = indexFind(pid);
+    if (slot == PCB_NO_SLOT)
+    {
+        slot = allocate();
+        indexInsert(pid, slot);
+        liveCount++;
+    }
+    PCBChunk *c = chunkOf(slot);
+    int i = offsetOf(slot);
+    c->pid[i] = pid;
+    c->priority[i] = pcb.getPriority();
+    c->value[i] = pcb.getValue();
+    c->start_time[i] = pcb.getStart();
+    c->run_time[i] = pcb.getRun();
+    c->cpu_time[i] = pcb.getCPU();
+    c->ready_since[i] = pcb.getReadySince();
+    c->wait_time[i] = pcb.getWait();
+    c->response_time[i] = pcb.getResponse();
+    c->live[i] = 1;
+    return PCBHandle{slot, c->generation[i]};
+}
+
+/*
+    Removes the PCB behind h from the index and puts its slot on the free list.
+    Returns false if h is stale (already retired).
+*/
+inline bool PCBStore::retire(PCBHandle h)
+{
+    if (!valid(h))
+    {
+        return false;
+    }
+    PCBChunk *c = chunkOf(h.slot);
+    int i = offsetOf(h.slot);
+    indexErase(c->pid[i]);
+    c->live[i] = 0;
+    c->generation[i]++;
+    c->nextFree[i] = freeHead;
+    freeHead = h.slot;
+    liveCount--;
+    return true;
+}
+
+//----| Getters |----//
+
+inline PCBHandle PCBStore::find(int pid) const
+{
+    unsigned int slot = indexFind(pid);
+    if (slot == PCB_NO_SLOT)
+    {
+        return PCBHandle{PCB_NO_SLOT, 0};
+    }
+    return PCBHandle{slot, chunkOf(slot)->generation[offsetOf(slot)]};
+}
+
+inline bool PCBStore::valid(PCBHandle h) const
+{
+    if (h.slot >= used)
+    {
+        return false;
+    }
+    PCBChunk *c = chunkOf(h.slot);
+    int i = offsetOf(h.slot);
+    return c->live[i] && c->generation[i] == h.generation;
+}
+
+inline PCBRef PCBStore::get(PCBHandle h)
+{
+    unsigned int slot = valid(h) ? h.slot : 0;
+    return PCBRef(chunkOf(slot), offsetOf(slot));
+}
+
+inline PCBRef PCBStore::operator[](int pid)
+{
+    unsigned int slot = indexFind(pid);
+    if (slot == PCB_NO_SLOT)
+    {
+        slot = 0;
+    }
+    return PCBRef(chunkOf(slot), offsetOf(slot));
+}
+
+//----| Columns |----//
+
+/*
+    pass sees the slots of each chunk that have been handed out; free slots and the placeholder among them
+    have live 0, so a pass weights by the live column.
+*/
+template <class Pass>
+void PCBStore::forEachChunk(Pass pass)
+{
+    for (int k = 0; k < chunkCount; k++)
+    {
+        pass(*chunks[k], chunkUsed(k));
+    }
+}
+
+//----| Checkpoint |----//
+
+inline void PCBStore::save(ImageWriter &out) const
+{
+    out.value(chunkCount);
+    out.value(used);
+    out.value(freeHead);
+    out.value(liveCount);
+    out.value(capacity);
+    for (int k = 0; k < chunkCount; k++)
+    {
+        out.bytes(chunks[k], sizeof(PCBChunk));
+    }
+    out.array(keys, capacity);
+    out.array(slots, capacity);
+}
+
+/*
+    Chunks are copied whole out of the image and the index is taken as is, so nothing is rehashed.
+*/
+inline bool PCBStore::load(ImageReader &in)
+{
+    for (int i = 0; i < chunkCount; i++)
+    {
+        delete chunks[i];
+    }
+    delete[] keys;
+    delete[] slots;
+    in.value(chunkCount);
+    in.value(used);
+    in.value(freeHead);
+    in.value(liveCount);
+    in.value(capacity);
+    if (!in.good() || chunkCount < 1 || used > (unsigned int)chunkCount * PCB_CHUNK || capacity == 0 || (capacity & (capacity - 1)))
+    {
+        chunkCount = 0;
+        keys = NULL;
+        slots = NULL;
+        return false;
+    }
+    chunkCapacity = chunkCount;
+    chunks = (PCBChunk **)realloc(chunks, chunkCapacity * sizeof(PCBChunk *));
+    for (int k = 0; k < chunkCount; k++)
+    {
+        chunks[k] = new PCBChunk;
+        in.bytes(chunks[k], sizeof(PCBChunk));
+    }
+    keys = new int[capacity];
+    slots = new unsigned int[capacity];
+    return in.array(keys, capacity) == capacity && in.array(slots, capacity) == capacity;
+}
+
+//----| Helpers |----//
+
+inline int PCBStore::chunkUsed(int chunk) const
+{
+    unsigned int base = (unsigned int)chunk * PCB_CHUNK;
+    return used - base < PCB_CHUNK ? used - base : PCB_CHUNK;
+}
+
+/*
+    Takes a slot off the free list, or the next never-used slot (allocating a zeroed chunk when needed).
+*/
+inline unsigned int PCBStore::allocate()
+{
+    if (freeHead != PCB_NO_SLOT)
+    {
+        unsigned int slot = freeHead;
+        freeHead = chunkOf(slot)->nextFree[offsetOf(slot)];
+        return slot;
+    }
+    if (used == (unsigned int)chunkCount * PCB_CHUNK)
+    {
+        if (chunkCount == chunkCapacity)
+        {
+            chunkCapacity = chunkCapacity ? chunkCapacity * 2 : 16;
+            chunks = (PCBChunk **)realloc(chunks, chunkCapacity * sizeof(PCBChunk *));
+            if (chunks == NULL)
+            {
+                cout << "Not enough memory to grow the PCB table" << endl;
+                exit(-1);
+            }
+        }
+        chunks[chunkCount] = new PCBChunk();
+        chunkCount++;
+    }
+    return used++;
+}
+
+/*
+    Returns the slot stored for pid; PCB_NO_SLOT if there is none.
+*/
+inline unsigned int PCBStore::indexFind(int pid) const
+{
+    for (unsigned int i = bucket(pid);; i = (i + 1) & (capacity - 1))
+    {
+        if (slots[i] == PCB_NO_SLOT || keys[i] == pid)
+        {
+            return slots[i];
+        }
+    }
+}
+
+/*
+    Adds pid -> slot, keeping the load factor at or below one half.
+*/
+inline void PCBStore::indexInsert(int pid, unsigned int slot)
+{
+    if ((unsigned int)(liveCount + 1) * 2 > capacity)
+    {
+        indexGrow();
+    }
+    unsigned int i = bucket(pid);
+    while (slots[i] != PCB_NO_SLOT)
+    {
+        i = (i + 1) & (capacity - 1);
+    }
+    keys[i] = pid;
+    slots[i] = slot;
+}
+
+/*
+    Removes pid using backward-shift deletion, so no tombstones are left behind in the probe chains.
+*/
+inline void PCBStore::indexErase(int pid)
+{
+    unsigned int mask = capacity - 1;
+    unsigned int i = bucket(pid);
+    while (keys[i] != pid || slots[i] == PCB_NO_SLOT)
+    {
+        i = (i + 1) & mask;
+    }
+    unsigned int j = i;
+    while (true)
+    {
+        j = (j + 1) & mask;
+        if (slots[j] == PCB_NO_SLOT)
+        {
+            break;
+        }
+        unsigned int home = bucket(keys[j]);
+        if (((j - home) & mask) >= ((j - i) & mask)) // Entry at j may move back into the hole at i
+        {
+            keys[i] = keys[j];
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i] = PCB_NO_SLOT;
+}
+
+/*
+    Doubles the number of buckets and reinserts every entry.
+*/
+inline void PCBStore::indexGrow()
+{
+    int *oldKeys = keys;
+    unsigned int *oldSlots = slots;
+    unsigned int oldCapacity = capacity;
+    capacity *= 2;
+    keys = new int[capacity];
+    slots = new unsigned int[capacity];
+    memset(slots, 0xFF, capacity * sizeof(unsigned int));
+    for (unsigned int b = 0; b < oldCapacity; b++)
+    {
+        if (oldSlots[b] != PCB_NO_SLOT)
+        {
+            unsigned int i = bucket(oldKeys[b]);
+            while (slots[i] != PCB_NO_SLOT)
+            {
+                i = (i + 1) & (capacity - 1);
+            }
+            keys[i] = oldKeys[b];
+            slots[i] = oldSlots[b];
+        }
+    }
+    delete[] oldKeys;
+    delete[] oldSlots;
+}
+
+#endif
@@ -2,7 +2,7 @@
     Author: Christopher Edmunds
     Date: 9/16/2024
     Last Updated: 9/25/2024
-    Description: Process Manager. The class object handles all of the logic for the process manager.
+    Description: Process Manager. The class object (process_manager.h) handles all of the logic for the process manager.
         The main function spawns the object, reads in input from commander (assuming input is already validated),
         and sends it off to the class object to digest and handle the command.
 */
@@ -13,387 +13,294 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
-#include <sstream>
-#include <vector>
-#include <map>
-#include <iomanip>
-#include <sys/wait.h>
 
 //====| Local Includes |====//
-#include "queue_array.h"
-#include "PCB.h"
+#include "process_manager.h"
+#include "command.h"
+#include "mpsc_ring.h"
+#include "producers.h"
+#include "shm_ring.h"
 
 //====| Namespace |====//
 using namespace std;
 
-//====| Process Manager Class |====//
-class Process_Manager
-{
-private:
-    int Time;                                                    // Global Time
-    PCB PCB_Table[100];                                          // Array of possible PCBs (Processes)
-    QueueArray<int> *ReadyState;                                 // (size 4 for everything)
-    QueueArray<int> *BlockedState[3];                            // 3 Resources to Block processes for
-    int RunningState[3] = {-1, -1, -1};                          // Holds PID, Time elapsed, and Quantum for current running process
-    map<int, int> quantumMap = {{0, 1}, {1, 2}, {2, 4}, {3, 8}}; // Map Priority to Quantum
-    double turnaroundTimeSum;                                    // Keeps track of the total time completed processes took
-    double processesCompleted;                                   // Keeps track of the processes completed
-    double totalProcesses;                                       // Keeps track of the total processes read
-
-    //----| Commands |----//
-    int S(int, int, int); // Creates and starts a new process
-    int B(int);           // Blocks currently running process
-    int U(int);           // Unblocks currently blocked process
-    int Q();              // Increments Time
-    int C(string, int);   // Perform operation on value of process
-    int P();              // Report current state of the process manager
-    int T();              // Report on the final information of the process manager (turnaround time, etc).
-
-    //----| Helpers |-----//
-    void swap(bool);              // Swap processes in and out of RunningState
-    void updateRunningState(int); // Updates the current running process by PID
+//====| Function Definitions |====//
 
-public:
-    //----|Constructor(s)|----//
-    Process_Manager();
-    ~Process_Manager();
-
-    //----| Helpers |----//
-    int digestInput(string); // Reads in string and processes it to call respective commands
+/*
+    Manager settings from the command line.
+*/
+struct ServeOptions
+{
+    int cores = 1;
+    string engine = "queues";
+    const char *checkpointPath = NULL;
+    const char *restorePath = NULL;
+    const char *tracePath = NULL;
+    ReportFormat reportFormat = REPORT_TEXT;
+    long long tickPeriod = 0;       // Microseconds per quantum in real-time mode; 0: only Q advances Time
+    const TickClock *clock = NULL;  // The armed clock whose TICK records arrive between the commands
+    const char *jobCommand = NULL;  // Shell command every S launches as a real job
+    int agingInterval = 0;          // Ticks of waiting per level of aging; 0: off
+    int starvationLimit = 0;        // Ready wait T counts as starvation; 0: the default once aging is on
 };
 
-//====| Main Program |====//
-
-int main(int argc, char *argv[])
+/*
+    Takes commands from a source (the producers' MPSCRing, or the commander's ShmRing) in arrival order and
+    sends each off to a process manager scheduling with Policy (resumed from restorePath if given), until T
+    or the end of every stream. With a tracePath, every scheduling event is also recorded there (see event_trace.h).
+    In real-time mode the source also carries TICK records from the clock, which advance Time like Q.
+    With a jobCommand every process is a real job the schedule is enforced on (see job_control.h).
+*/
+template <class Policy, class Source>
+void serve(Source &commands, const ServeOptions &options)
 {
-    int mcpipe2[2];
-    char chr;
-    Process_Manager pm = Process_Manager();
-    int result;
-
-    mcpipe2[0] = atoi(argv[1]);
-    mcpipe2[1] = atoi(argv[2]);
-
-    close(mcpipe2[1]); // Don't need this. . .
-
-    string str = "";
-    while (read(mcpipe2[0], &chr, 1)) // Build string from one char at a time, send string off to process manager object
+    Process_Manager<Policy> pm(options.cores);
+    pm.setReportFormat(options.reportFormat);
+    if (options.clock != NULL)
+    {
+        pm.setTickPeriod(options.tickPeriod);
+    }
+    if (options.agingInterval > 0 || options.starvationLimit > 0)
     {
-        if (chr != 0)
+        if (options.agingInterval > 0 && !Policy::ages)
         {
-            str.push_back(chr);
+            cerr << "the " << Policy::name << " scheduler does not age processes; only starvation is reported" << endl;
         }
-        else
+        pm.setAging(options.agingInterval, options.starvationLimit);
+    }
+    if (options.checkpointPath != NULL)
+    {
+        pm.setCheckpointPath(options.checkpointPath);
+    }
+    if (options.restorePath != NULL && !pm.restore(options.restorePath))
+    {
+        exit(1);
+    }
+    EventTrace *trace = NULL;
+    if (options.tracePath != NULL)
+    {
+        trace = new EventTrace(options.tracePath, Policy::name, pm.getCores(), Policy::levels);
+        if (!trace->good())
         {
-            result = pm.digestInput(str);
-            if (str[0] == 'T')
-            {
-                break;
-            }
-            str = "";
+            cerr << "could not write trace " << options.tracePath << endl;
+            exit(1);
         }
+        pm.setTrace(trace);
     }
-    close(mcpipe2[0]);
-
-    return 1;
-}
-
-//====| Class Definitions |====//
-
-//====| Constructors |====//
-
-Process_Manager::Process_Manager() : Time(0), turnaroundTimeSum(0), processesCompleted(0), totalProcesses(0)
-{
-    ReadyState = new QueueArray<int>(4);
-    for (int i = 0; i < 3; i++)
+    JobControl *jobs = NULL;
+    if (options.jobCommand != NULL)
     {
-        BlockedState[i] = new QueueArray<int>(4);
+        jobs = new JobControl(options.jobCommand);
+        pm.setJobs(jobs);
     }
+    Command cmd;
+    while (true)
+    {
+        commands.pop(cmd);
+        if (cmd.op == END_OF_STREAM)
+        {
+            break;
+        }
+        if (cmd.op == TICK)
+        {
+            pm.tick(cmd.arg[0], options.clock->lateness(cmd.arg[1]));
+            continue;
+        }
+        pm.digestCommand(cmd);
+        if (cmd.op == 'T')
+        {
+            break;
+        }
+    }
+    pm.setTrace(NULL);
+    delete trace; // Writes out the rest of the trace
+    pm.setJobs(NULL);
+    delete jobs;  // Kills the jobs still running
 }
 
-Process_Manager::~Process_Manager()
-{
-    delete ReadyState;
-}
-
-//====| Commands |====//
-
 /*
-    Creates and starts new process. If process already running, add to ReadyState (queue process to run)
+    Runs serve with the scheduler engine the options name.
 */
-int Process_Manager::S(int pid, int value, int run_time)
+template <class Source>
+void serveEngine(Source &commands, const ServeOptions &options)
 {
-    totalProcesses++;
-    PCB_Table[pid] = PCB(pid, value, run_time, Time);
-    if (RunningState[0] == -1) // If RunningState has no process
+    if (options.engine == "cfs")
     {
-        updateRunningState(pid);
+        serve<CFSPolicy>(commands, options);
     }
     else
     {
-        ReadyState->Enqueue(pid, PCB_Table[pid].getPriority());
+        serve<PM_POLICY>(commands, options);
     }
-    return 0;
 }
 
-/*
-    Decrement priority and block currently running process (queue onto block with resource rid).
-    Next process from ReadyState now runs
-*/
-int Process_Manager::B(int rid)
-{
-    int pid = RunningState[0];
-    PCB_Table[pid].decrementPriority();
-    BlockedState[rid]->Enqueue(pid, PCB_Table[pid].getPriority());
-    pid = ReadyState->Dequeue();
-    updateRunningState(pid);
-    return 0;
-}
+//====| Main Program |====//
 
 /*
-    Unblock first process from the BlockedState (dequeue off of block with resource rid).
+    Usage: processManager read_fd write_fd [-n cores] [-e engine] [-k checkpoint] [-R checkpoint] [-j trace] [-o format] [-t period_us] [-x command] [-a interval] [-W ticks] [-m ring_fd] [-l socket_path] [-w io_threads]
+        read_fd/write_fd  the commander's pipe; pass -1 -1 to only take commands from the socket or shared ring
+        -e  scheduler engine: queues (the policy this build was made with, default) or cfs (virtual runtime heap)
+        -k  file the K command checkpoints to (default processManager.ckpt)
+        -R  resume from a checkpoint (same engine; its core count replaces -n)
+        -j  record a binary trace of scheduling events to a file (summarize it with traceView)
+        -o  report format: text (default) or json (one object per P, T or I report, one per line)
+        -t  real-time mode: a timer advances Time by one quantum every period_us microseconds, between the commands
+        -x  real processes: S runs command (sh -c, with PM_PID, PM_VALUE and PM_RUNTIME set) as a job that is
+            only continued while its process runs, pinned to that core's CPU
+        -a  aging (mlfq and priority): a ready process counts as one level higher per interval ticks it waits
+        -W  ready wait that T counts as starvation (default 100 ticks; -W alone reports it without aging)
+        -m  take commands from the shared-memory ring in this inherited memfd (commander -m) instead of producers
+        -l  also accept commanders on a Unix socket (commander -s socket_path)
+        -w  number of I/O threads reading producers (default 2)
 */
-int Process_Manager::U(int rid)
+int main(int argc, char *argv[])
 {
-    int pid = BlockedState[rid]->Dequeue();
-    if (RunningState[0] < 1)
-    {
-        updateRunningState(pid);
-    }
-    else
+    int mcpipe2[2];
+    int opt;
+    int ioThreads = 2;
+    int ringFd = -1;
+    const char *socketPath = NULL;
+    ServeOptions options;
+
+    if (argc < 3)
     {
-        ReadyState->Enqueue(pid, PCB_Table[pid].getPriority());
+        cerr << "usage: " << argv[0] << " read_fd write_fd [-n cores] [-e engine] [-k checkpoint] [-R checkpoint] [-j trace] [-o format] [-t period_us] [-x command] [-a interval] [-W ticks] [-m ring_fd] [-l socket_path] [-w io_threads]" << endl;
+        exit(1);
     }
-    return 0;
-}
+    mcpipe2[0] = atoi(argv[1]);
+    mcpipe2[1] = atoi(argv[2]);
 
-/*
-    Increment Time.
-    Check if process has finished and swap if needed.
-    Check if process has met quantum and swap if needed
-*/
-int Process_Manager::Q()
-{
-    if (RunningState[0] < 1) // FLAG
+    while ((opt = getopt(argc - 2, argv + 2, "n:e:k:R:j:o:t:x:a:W:m:l:w:")) != -1) // Options follow the two descriptors
     {
-        if (ReadyState->QAsize() > 0)
-        {
-            int pid = ReadyState->Dequeue();
-            updateRunningState(pid);
-        }
-        else
+        switch (opt)
         {
-            return 1;
+        case 'n':
+            options.cores = atoi(optarg);
+            break;
+        case 'e':
+            options.engine = optarg;
+            break;
+        case 'k':
+            options.checkpointPath = optarg;
+            break;
+        case 'R':
+            options.restorePath = optarg;
+            break;
+        case 'j':
+            options.tracePath = optarg;
+            break;
+        case 'o':
+            if (string(optarg) != "text" && string(optarg) != "json")
+            {
+                cerr << "unknown report format " << optarg << " (text or json)" << endl;
+                exit(1);
+            }
+            options.reportFormat = string(optarg) == "json" ? REPORT_JSON : REPORT_TEXT;
+            break;
+        case 't':
+            options.tickPeriod = atoll(optarg);
+            if (options.tickPeriod < 1)
+            {
+                cerr << "the tick period must be at least 1 us" << endl;
+                exit(1);
+            }
+            break;
+        case 'x':
+            options.jobCommand = optarg;
+            break;
+        case 'a':
+            options.agingInterval = atoi(optarg);
+            break;
+        case 'W':
+            options.starvationLimit = atoi(optarg);
+            break;
+        case 'm':
+            ringFd = atoi(optarg);
+            break;
+        case 'l':
+            socketPath = optarg;
+            break;
+        case 'w':
+            ioThreads = atoi(optarg);
+            break;
+        default:
+            cerr << "usage: " << argv[0] << " read_fd write_fd [-n cores] [-e engine] [-k checkpoint] [-R checkpoint] [-j trace] [-o format] [-t period_us] [-x command] [-a interval] [-W ticks] [-m ring_fd] [-l socket_path] [-w io_threads]" << endl;
+            exit(1);
         }
     }
-    Time++;
-    RunningState[1]++; // Increment current time elapsed for the running process
-
-    if (PCB_Table[RunningState[0]].incrementTime()) // Is Process Finished?
+    if (options.cores < 1)
     {
-        processesCompleted++;
-        turnaroundTimeSum += Time - (PCB_Table[RunningState[0]].getStart());
-        swap(true); // Done with this process = true
+        options.cores = 1;
     }
-
-    if (RunningState[1] >= RunningState[2]) // If time elapsed >= quantum, change process
+    if (ioThreads < 1)
     {
-        swap(false); // Not done with this process
+        ioThreads = 1;
     }
-
-    return 0;
-}
-
-/*
-    Operate on value of currently running process
-*/
-int Process_Manager::C(string cmd, int val)
-{
-    int pcbVal = PCB_Table[RunningState[0]].getValue();
-    switch (cmd[0])
+    if (options.engine != "queues" && options.engine != "cfs")
     {
-    case 'A':
-        PCB_Table[RunningState[0]].setValue(pcbVal + val);
-        break;
-    case 'S':
-        PCB_Table[RunningState[0]].setValue(pcbVal - val);
-        break;
-    case 'M':
-        PCB_Table[RunningState[0]].setValue(pcbVal * val);
-        break;
-    case 'D':
-        PCB_Table[RunningState[0]].setValue(pcbVal / val);
-        break;
-    default:
-        return 1;
+        cerr << "unknown engine " << options.engine << " (queues or cfs)" << endl;
+        exit(1);
     }
-    return Q();
-}
-
-/*
-    Spawn reporter (fork) and print the current state of processManager. Master waits for child to terminate.
-*/
-int Process_Manager::P()
-{
-    int c1, status;
-    if ((c1 = fork()) == -1)
+    if (options.jobCommand != NULL && options.restorePath != NULL)
     {
-        perror("unable to fork child for printing");
+        cerr << "-x cannot be combined with -R: a checkpoint does not hold the jobs" << endl;
         exit(1);
     }
-    else if (c1 == 0)
-    {
-        string header = "PID  Priority Value  Start Time  Total CPU time";
-
-        cout << "*****************************************************\nThe current system state is as follows : \n*****************************************************\n " << endl;
-        cout
-            << "CURRENT TIME: "
-            << Time
-            << endl
-            << endl
-            << "RUNNING PROCESS:"
-            << endl;
-
-        cout << header << endl;
-        cout << PCB_Table[RunningState[0]] << endl;
 
-        cout << "BLOCKED PROCESS:" << endl;
-        int *blocked;
-        for (int i = 0; i < 3; i++)
+    if (ringFd >= 0) // One commander, straight through shared memory: no producer threads
+    {
+        if (socketPath != NULL)
         {
-            int rsize = BlockedState[i]->QAsize();
-            cout << "Queue of processes Blocked for resource " << i << (rsize == 0 ? " is empty" : ":") << endl;
-            if (rsize > 0)
-            {
-                cout << header << endl;
-                for (int j = 0; j < 4; j++)
-                {
-                    int size = BlockedState[i]->Qsize(j);
-                    if (size > 0)
-                    {
-                        blocked = BlockedState[i]->Qstate(j);
-                        for (int k = 0; k < size; k++)
-                        {
-                            cout << PCB_Table[blocked[k]];
-                        }
-                        delete[] blocked;
-                    }
-                }
-            }
+            cerr << "-m and -l cannot be combined" << endl;
+            exit(1);
         }
-
-        cout << endl;
-
-        cout << "PROCESSES READY TO EXECUTE:" << endl;
-        for (int i = 0; i < 4; i++)
+        if (options.tickPeriod > 0)
         {
-            int size = ReadyState->Qsize(i);
-            cout << "Queue of processes with priority " << i << ((size == 0) ? " is empty" : ":") << endl;
-            if (size > 0)
-            {
-                cout << header << endl;
-                int *ready = ReadyState->Qstate(i);
-                for (int j = 0; j < size; j++)
-                {
-                    cout << PCB_Table[ready[j]];
-                }
-            }
+            cerr << "-t needs the producer event loop and cannot be combined with -m" << endl;
+            exit(1);
         }
-        cout << "*****************************************************" << endl
-             << endl;
-        exit(0);
-    }
-    else
-    { // parent
+        ShmRing *ring = ShmRing::map(ringFd);
+        if (ring == NULL)
+        {
+            exit(1);
+        }
+        serveEngine(*ring, options);
+        return 1;
     }
-    wait(&status);
-    return 0;
-}
 
-/*
-    Spawn reporter (fork) and print turnaround time of process manager.
-*/
-int Process_Manager::T()
-{
-    int c1, status;
-    if ((c1 = fork()) == -1)
+    MPSCRing<Command> commands(PRODUCER_RING);
+    ProducerLoop producers(commands, ioThreads);
+    if (mcpipe2[1] >= 0)
     {
-        perror("unable to fork child for printing");
-        exit(1);
+        close(mcpipe2[1]); // Don't need this. . .
     }
-    else if (c1 == 0)
+    if (mcpipe2[0] >= 0)
     {
-        cout << "The average Turnaround Time: " << (processesCompleted ? turnaroundTimeSum / processesCompleted : processesCompleted) << endl
-             << endl;
-        cout << "Extra information you might want to know:" << endl;
-        cout << processesCompleted << " processes finished in a total of " << turnaroundTimeSum << " seconds" << endl;
-        exit(0);
+        producers.add(mcpipe2[0]);
     }
-    wait(&status);
-    return 0;
-}
-//====| Helpers |====//
-
-/*
-    Swaps ReadyState and RunningState.
-    done indicates if a process is finished. If process is finished (done), process does not go back to ReadyState.
-    If process is not finsihed (not done), process swaps with ReadyState and RunningState.
-*/
-void Process_Manager::swap(bool done)
-{
-    if (!done) // If process has not completed (Has met quantum), enqueue it
+    if (socketPath != NULL && !producers.listen(socketPath))
     {
-        PCB_Table[RunningState[0]].incrementPriority(); // Increment priority since it's met it's quantum
-        ReadyState->Enqueue(RunningState[0], PCB_Table[RunningState[0]].getPriority());
+        exit(1);
     }
-
-    int pid = ReadyState->Dequeue();
-    updateRunningState(pid);
-}
-
-/*
-    Tokenizes string input into arugments and runs varying commands based on the args.
-*/
-int Process_Manager::digestInput(string input)
-{
-    istringstream iss(input);
-    string s;
-    vector<string> args = vector<string>();
-    while (getline(iss, s, ' '))
+    if (mcpipe2[0] < 0 && socketPath == NULL)
     {
-        args.push_back(s);
+        cerr << "no command producers" << endl;
+        exit(1);
     }
-    switch (input[0])
+    TickClock clock;
+    if (options.tickPeriod > 0)
     {
-    case 'S':
-        return S(atoi(args[1].c_str()), atoi(args[2].c_str()), atoi(args[3].c_str()));
-    case 'B':
-        return B(atoi(args[1].c_str()));
-    case 'U':
-        return U(atoi(args[1].c_str()));
-    case 'Q':
-        return Q();
-    case 'C':
-        return C(args[1], atoi(args[2].c_str()));
-    case 'P':
-        return P();
-    case 'T':
-        return T();
-    default:
-        perror("Incorrect Command");
-        exit(1);
-        break;
+        if (!clock.arm(options.tickPeriod))
+        {
+            exit(1);
+        }
+        producers.addTicker(clock);
+        options.clock = &clock;
     }
-    return 0;
-};
+    producers.start();
 
-/*
-    Updates the running state.
-    Time elapsed is for comparing if process has met quantum
-*/
-void Process_Manager::updateRunningState(int pid)
-{
-    RunningState[0] = pid;                                      // Pointer to process is PID
-    RunningState[1] = 0;                                        // Set current time elapsed for process on CPU back to 0
-    RunningState[2] = quantumMap[PCB_Table[pid].getPriority()]; // Set quantum based on priority
-}
\ No newline at end of file
+    serveEngine(commands, options);
+    producers.stop();
+
+    return 1;
+}
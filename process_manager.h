@@ -0,0 +1,948 @@
+#ifndef PROCESS_MANAGER_H
+#define PROCESS_MANAGER_H
+/*
+    Process Manager. The class object handles all of the logic for the process manager:
+    digestInput/digestCommand take one command and call the respective command.
+    The scheduling policy (quantum per level, priority changes, which process runs next) is the
+    Policy template parameter, see scheduling_policy.h.
+*/
+//====| STL Includes |====//
+#include <iostream>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <sstream>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <type_traits>
+
+//====| Local Includes |====//
+#include "queue_array.h"
+#include "PCB.h"
+#include "pcb_store.h"
+#include "command.h"
+#include "reporter.h"
+#include "stats.h"
+#include "latency_histogram.h"
+#include "scheduling_policy.h"
+#include "resource_table.h"
+#include "timing_wheel.h"
+#include "image.h"
+#include "event_trace.h"
+#include "tick_clock.h"
+#include "job_control.h"
+
+//====| Namespace |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define REPORTED_RESOURCES 3 // Resources 0-2 are always in the P report; others only while they have waiters
+#define CHECKPOINT_MAGIC 0x31544B4350434D50ULL // "PMCPCKT1"
+#define CHECKPOINT_VERSION 3
+#define STARVATION_TICKS 100 // Default ready wait that counts as starvation in T once aging is on
+
+//====| Core |====//
+/*
+    One simulated CPU: its running slot, its own ready queue (the policy's ReadyQueue), and its statistics.
+*/
+template <class ReadyQueue>
+struct Core
+{
+    int RunningState[3] = {-1, -1, -1}; // Holds PID, Time elapsed, and Quantum for current running process
+    ReadyQueue *ReadyState;             // (size 4 for everything)
+    bool ticking;                       // Has a process for the current Q step
+    double busyTime;                    // Ticks spent running a process
+    double turnaroundTimeSum;           // Turnaround of the processes that completed on this core
+    double processesCompleted;          // Processes that completed on this core
+    double steals;                      // Processes taken from other cores' ready queues
+};
+
+//====| Process Manager Class |====//
+template <class Policy = PM_POLICY>
+class Process_Manager
+{
+private:
+    typedef Core<typename Policy::ReadyQueue> CoreState;
+
+    int Time;                                                    // Global Time
+    PCBStore PCB_Table;                                          // Slab of PCBs (Processes), indexed by PID
+    CoreState *Cores;                                            // Running and ready state of each CPU
+    int coreCount;                                               // Number of CPUs
+    ResourceTable BlockedState;                                  // Processes blocked on each resource (any rid)
+    TimingWheel timeouts;                                        // Deadlines of timed blocks, by BlockedState node
+    Policy policy;                                               // Quantum table, priority changes and next process choice
+    double turnaroundTimeSum;                                    // Keeps track of the total time completed processes took
+    double processesCompleted;                                   // Keeps track of the processes completed
+    double totalProcesses;                                       // Keeps track of the total processes read
+    LatencyHistogram turnaroundTimes;                            // Distributions over completed processes
+    LatencyHistogram waitingTimes;
+    LatencyHistogram responseTimes;
+    Reporter reporter;                                           // Prints P and T snapshots on its own thread
+    string checkpointPath;                                       // Image the K command writes
+    EventTrace *trace;                                           // Scheduling event trace; NULL when off
+    TickStats ticks;                                             // Real-time ticks run so far (-t)
+    JobControl *jobs;                                            // Real jobs behind the processes; NULL when off (-x)
+    int agingInterval;                                           // Ticks of waiting that raise a process one level; 0: off (-a)
+    int starvationLimit;                                         // Ready waits this long count as starved; 0: not reported (-W)
+    long long promotions;                                        // Levels processes have risen by aging
+    long long starvedDispatches;                                 // Dispatches that came after a starved wait
+    int longestWait;                                             // Longest single ready wait that ended in a dispatch
+
+    //----| Commands |----//
+    int S(int, int, int); // Creates and starts a new process
+    int B(int, int, int); // Blocks the process running on a core (until unblocked, or for a number of ticks)
+    int U(int, int);      // Unblocks currently blocked process (onto a core, or -1 for any)
+    int Q(int ticks = 1); // Increments Time (by up to ticks quanta)
+    int C(char, int, int); // Perform operation on value of the process running on a core
+    int P();              // Report current state of the process manager
+    int T();              // Report on the final information of the process manager (turnaround time, etc).
+    int I();              // Report the hot-path statistics (builds with -DPM_STATS)
+    int K();              // Checkpoint the whole scheduler state to checkpointPath
+
+    //----| Helpers |-----//
+    void swap(int, bool);              // Swap processes in and out of a core's RunningState
+    void wake(int, int);               // Puts an unblocked process on a core (or -1 for any)
+    void wakeTimedOut();               // Wakes the processes whose block has timed out by Time
+    void updateRunningState(int, int); // Updates the process running on a core by PID
+    bool hasReady(int);                // Is there a process the core could run (its own or one to steal)?
+    int nextProcess(int);              // Dequeues the core's next process, stealing if its queue is empty
+    int select(typename Policy::ReadyQueue &); // The policy's choice from a ready queue, after aging
+    int leastLoaded();                 // Core with the fewest queued processes
+    void traceEvent(TraceKind, int, int, int); // Records an event (kind, core, pid, arg) if tracing is on
+
+public:
+    //----|Constructor(s)|----//
+    Process_Manager(int cores = 1);
+    ~Process_Manager();
+
+    //----| Helpers |----//
+    int digestInput(string_view);         // Parses a text command and calls the respective command
+    int digestCommand(const Command &);   // Calls the respective command for a decoded Command record
+
+    //----| Checkpoint |----//
+    void setCheckpointPath(const string &path) { checkpointPath = path; }
+    bool restore(const string &path);     // Resumes from an image written by K (same policy)
+
+    //----| Reports |----//
+    void setReportFormat(ReportFormat format) { reporter.setFormat(format); } // Text (default) or JSON
+
+    //----| Real Time |----//
+    void setTickPeriod(long long micros) { ticks.period = micros; } // Reports tick statistics in T
+    int tick(int periods, long long lateness);                     // Runs a timer tick periods quanta long
+
+    //----| Aging |----//
+    void setAging(int interval, int limit); // Raises waiting processes a level per interval ticks (0: off)
+
+    //----| Real Processes |----//
+    void setJobs(JobControl *j) { jobs = j; } // Launches and stops a job in j for every process (before the first S)
+
+    //----| Tracing |----//
+    void setTrace(EventTrace *t) { trace = t; } // Records scheduling events into t (NULL stops)
+    int getCores() const { return coreCount; }
+};
+
+//====| Class Definitions |====//
+
+//====| Constructors |====//
+
+template <class Policy>
+Process_Manager<Policy>::Process_Manager(int cores) : Time(0), coreCount(cores), BlockedState(Policy::levels),
+                                                     turnaroundTimeSum(0), processesCompleted(0), totalProcesses(0),
+                                                     checkpointPath("processManager.ckpt"), trace(NULL), jobs(NULL),
+                                                     agingInterval(0), starvationLimit(0), promotions(0),
+                                                     starvedDispatches(0), longestWait(0)
+{
+    Cores = new CoreState[coreCount];
+    for (int c = 0; c < coreCount; c++)
+    {
+        Cores[c].ReadyState = new typename Policy::ReadyQueue(Policy::levels);
+        Cores[c].busyTime = Cores[c].turnaroundTimeSum = Cores[c].processesCompleted = Cores[c].steals = 0;
+    }
+}
+
+template <class Policy>
+Process_Manager<Policy>::~Process_Manager()
+{
+    for (int c = 0; c < coreCount; c++)
+    {
+        delete Cores[c].ReadyState;
+    }
+    delete[] Cores;
+}
+
+//====| Commands |====//
+
+/*
+    Creates and starts new process on the first core that has never run one.
+    If every core has, add it to the ReadyState of the least loaded core (queue process to run)
+*/
+template <class Policy>
+int Process_Manager<Policy>::S(int pid, int value, int run_time)
+{
+    totalProcesses++;
+    PCB_Table.insert(PCB(pid, value, run_time, Time));
+    policy.started(PCB_Table[pid]);
+    traceEvent(TRACE_START, -1, pid, run_time);
+    if (jobs != NULL)
+    {
+        jobs->launch(pid, value, run_time);
+    }
+    for (int c = 0; c < coreCount; c++)
+    {
+        if (Cores[c].RunningState[0] == -1) // If RunningState has no process
+        {
+            updateRunningState(c, pid);
+            return 0;
+        }
+    }
+    policy.enqueue(*Cores[leastLoaded()].ReadyState, PCB_Table[pid]);
+    return 0;
+}
+
+/*
+    Let the policy adjust the priority (MLFQ: decrement) and block the process running on core (queue onto block with resource rid).
+    Next process from the core's ReadyState now runs.
+    With a timeout (> 0) the process unblocks by itself once Time reaches the current Time + timeout,
+    unless a U gets to it first.
+*/
+template <class Policy>
+int Process_Manager<Policy>::B(int rid, int core, int timeout)
+{
+    if (core < 0 || core >= coreCount)
+    {
+        return 1;
+    }
+    int pid = Cores[core].RunningState[0];
+    if (pid < 1) // No process running on core, nothing to block
+    {
+        return 0;
+    }
+    policy.blocked(PCB_Table[pid]);
+    traceEvent(TRACE_BLOCK, core, pid, rid);
+    int node = BlockedState.block(rid, pid, PCB_Table[pid].getPriority());
+    if (timeout > 0)
+    {
+        timeouts.schedule(node, (long long)Time + timeout);
+    }
+    updateRunningState(core, nextProcess(core));
+    return 0;
+}
+
+/*
+    Unblock first process from the BlockedState (dequeue off of block with resource rid), cancelling its
+    timeout if it had one, and wake it on core (-1 for any).
+*/
+template <class Policy>
+int Process_Manager<Policy>::U(int rid, int core)
+{
+    if (core >= coreCount)
+    {
+        return 1;
+    }
+    int node = BlockedState.front(rid);
+    if (node == RT_NONE) // Nothing blocked on rid
+    {
+        return 0;
+    }
+    int pid = BlockedState.pidOf(node);
+    timeouts.cancel(node);
+    BlockedState.remove(node);
+    traceEvent(TRACE_UNBLOCK, core, pid, rid);
+    wake(pid, core);
+    return 0;
+}
+
+/*
+    Increment Time, ticks times. Every core runs its process for each tick.
+    Check if process has finished and swap if needed.
+    Check if process has met quantum and swap if needed
+    Between two events (quantum expiry or process completion on any core) a tick only adds one to the
+    clock, and to each running process's elapsed time and CPU time, so those ticks are applied in one step.
+    The next slot of the timeout wheel is an event too; blocks that have timed out are woken after each step.
+    While no core has anything to run, the clock only moves on toward a pending timeout.
+    The resulting state is identical to calling Q() ticks times.
+*/
+template <class Policy>
+int Process_Manager<Policy>::Q(int ticks)
+{
+    STATS(pmStats.Q++);
+    while (ticks > 0)
+    {
+        int step = ticks; // Ticks to the next event
+        bool busy = false;
+        for (int c = 0; c < coreCount; c++)
+        {
+            CoreState &cpu = Cores[c];
+            cpu.ticking = true;
+            PCBHandle running = PCB_Table.find(cpu.RunningState[0]);
+            while (cpu.RunningState[0] < 1 || !PCB_Table.valid(running)) // FLAG: idle, or holding no stored process
+            {
+                if (!hasReady(c))
+                {
+                    break;
+                }
+                updateRunningState(c, nextProcess(c));
+                running = PCB_Table.find(cpu.RunningState[0]);
+            }
+            if (cpu.RunningState[0] < 1 || !PCB_Table.valid(running))
+            {
+                cpu.ticking = false; // Nothing for this core to run
+                continue;
+            }
+            busy = true;
+            PCBRef pcb = PCB_Table.get(running);
+            step = min(step, min(cpu.RunningState[2] - cpu.RunningState[1], pcb.getRun() - pcb.getCPU()));
+        }
+        if (!timeouts.empty())
+        {
+            step = min((long long)step, timeouts.nextEvent() - Time);
+        }
+        if (!busy)
+        {
+            if (timeouts.empty())
+            {
+                return 1; // Nothing left to run, the remaining ticks would not change anything
+            }
+            ticks -= step; // Idle until the next timeout
+            Time += step;
+            wakeTimedOut();
+            continue;
+        }
+        if (step < 1)
+        {
+            step = 1;
+        }
+        ticks -= step;
+        Time += step;
+        for (int c = 0; c < coreCount; c++) // Every core's step counts before any core picks its next process
+        {
+            if (Cores[c].ticking)
+            {
+                policy.charge(PCB_Table[Cores[c].RunningState[0]].getPriority(), step);
+            }
+        }
+
+        for (int c = 0; c < coreCount; c++)
+        {
+            CoreState &cpu = Cores[c];
+            if (!cpu.ticking)
+            {
+                continue;
+            }
+            cpu.RunningState[1] += step; // Increment current time elapsed for the running process
+            cpu.busyTime += step;
+
+            PCBHandle running = PCB_Table.find(cpu.RunningState[0]);
+            PCBRef pcb = PCB_Table.get(running);
+            if (PCB_Table.valid(running) && pcb.addTime(step)) // Is Process Finished? (only a stored process can be)
+            {
+                processesCompleted++;
+                turnaroundTimeSum += Time - pcb.getStart();
+                cpu.processesCompleted++;
+                cpu.turnaroundTimeSum += Time - pcb.getStart();
+                turnaroundTimes.record(Time - pcb.getStart());
+                waitingTimes.record(pcb.getWait());
+                responseTimes.record(pcb.getResponse());
+                traceEvent(TRACE_EXIT, c, cpu.RunningState[0], Time - pcb.getStart());
+                if (jobs != NULL)
+                {
+                    jobs->finish(cpu.RunningState[0]);
+                }
+                PCB_Table.retire(running); // Slot goes back to the free list
+                swap(c, true);             // Done with this process = true
+            }
+
+            if (cpu.RunningState[1] >= cpu.RunningState[2]) // If time elapsed >= quantum, change process
+            {
+                swap(c, false); // Not done with this process
+            }
+        }
+        wakeTimedOut();
+    }
+    return 0;
+}
+
+/*
+    Operate on value of the process running on core
+*/
+template <class Policy>
+int Process_Manager<Policy>::C(char cmd, int val, int core)
+{
+    if (core < 0 || core >= coreCount)
+    {
+        return 1;
+    }
+    int pid = Cores[core].RunningState[0];
+    int pcbVal = PCB_Table[pid].getValue();
+    switch (cmd)
+    {
+    case 'A':
+        PCB_Table[pid].setValue(pcbVal + val);
+        break;
+    case 'S':
+        PCB_Table[pid].setValue(pcbVal - val);
+        break;
+    case 'M':
+        PCB_Table[pid].setValue(pcbVal * val);
+        break;
+    case 'D':
+        PCB_Table[pid].setValue(pcbVal / val);
+        break;
+    default:
+        return 1;
+    }
+    return Q();
+}
+
+/*
+    Snapshot the current state of processManager and hand it to the reporter thread to print.
+*/
+template <class Policy>
+int Process_Manager<Policy>::P()
+{
+    Snapshot &snap = reporter.acquire();
+    snap.kind = 'P';
+    snap.Time = Time;
+    snap.cores = coreCount;
+    snap.levels = Policy::levels;
+    snap.running.clear();
+    snap.counts.clear();
+    snap.rows.clear();
+    for (int c = 0; c < coreCount; c++)
+    {
+        snap.running.push_back(PCBRow::of(PCB_Table[Cores[c].RunningState[0]]));
+    }
+    snap.resourceIds.clear();
+    for (int rid = 0; rid < REPORTED_RESOURCES; rid++) // The original resources are always listed, empty or not
+    {
+        snap.resourceIds.push_back(rid);
+    }
+    for (int rid : BlockedState.withWaiters())
+    {
+        if (rid < 0 || rid >= REPORTED_RESOURCES)
+        {
+            snap.resourceIds.push_back(rid);
+        }
+    }
+    sort(snap.resourceIds.begin() + REPORTED_RESOURCES, snap.resourceIds.end());
+    snap.resources = snap.resourceIds.size();
+    for (int rid : snap.resourceIds)
+    {
+        snap.counts.push_back(BlockedState.waiting(rid));
+        BlockedState.forEachWaiter(rid, [&](int pid)
+                                   { snap.rows.push_back(PCBRow::of(PCB_Table[pid])); });
+    }
+    for (int c = 0; c < coreCount; c++)
+    {
+        for (int i = 0; i < Policy::levels; i++)
+        {
+            snap.counts.push_back(Cores[c].ReadyState->Qsize(i));
+            for (int pid : Cores[c].ReadyState->Qview(i))
+            {
+                snap.rows.push_back(PCBRow::of(PCB_Table[pid]));
+            }
+        }
+    }
+    if (jobs != NULL) // CPU time is the jobs' real CPU time
+    {
+        for (PCBRow &row : snap.running)
+        {
+            row.cpu_time = jobs->cpuMillis(row.pid, row.cpu_time);
+        }
+        for (PCBRow &row : snap.rows)
+        {
+            row.cpu_time = jobs->cpuMillis(row.pid, row.cpu_time);
+        }
+    }
+    reporter.publish();
+    return 0;
+}
+
+/*
+    Snapshot the turnaround totals (and per-core statistics) and hand them to the reporter thread to print.
+*/
+template <class Policy>
+int Process_Manager<Policy>::T()
+{
+    Snapshot &snap = reporter.acquire();
+    snap.kind = 'T';
+    snap.Time = Time;
+    snap.cores = coreCount;
+    snap.turnaroundTimeSum = turnaroundTimeSum;
+    snap.processesCompleted = processesCompleted;
+    snap.turnaroundTimes = turnaroundTimes;
+    snap.waitingTimes = waitingTimes;
+    snap.responseTimes = responseTimes;
+    snap.ticks = ticks;
+    snap.jobs = jobs != NULL ? jobs->getStats() : JobStats();
+    int longestQueued = 0; // Processes still waiting are starving too; each level's front has waited longest
+    if constexpr (is_same<typename Policy::ReadyQueue, QueueArray<int>>::value)
+    {
+        for (int c = 0; c < coreCount; c++)
+        {
+            for (int level = 0; level < Policy::levels; level++)
+            {
+                if (Cores[c].ReadyState->Qsize(level) > 0)
+                {
+                    longestQueued = max(longestQueued, Time - PCB_Table[*Cores[c].ReadyState->Qview(level).begin()].getReadySince());
+                }
+            }
+        }
+    }
+    snap.aging = AgingRow{agingInterval, starvationLimit, promotions, starvedDispatches, longestWait, longestQueued};
+    snap.coreStats.clear();
+    for (int c = 0; c < coreCount; c++)
+    {
+        snap.coreStats.push_back(CoreRow{Cores[c].busyTime, Cores[c].turnaroundTimeSum, Cores[c].processesCompleted, Cores[c].steals});
+    }
+    reporter.publish();
+    return 0;
+}
+/*
+    Snapshot the statistics counters and hand them to the reporter thread to print.
+*/
+template <class Policy>
+int Process_Manager<Policy>::I()
+{
+    Snapshot &snap = reporter.acquire();
+    snap.kind = 'I';
+#ifdef PM_STATS
+    snap.statsEnabled = true;
+    snap.stats = pmStats;
+#else
+    snap.statsEnabled = false;
+#endif
+    reporter.publish();
+    return 0;
+}
+
+/*
+    Write a versioned binary image of the whole scheduler state: clock, counters and distributions,
+    policy state, aging, starvation and real-time tick counters, PCB_Table, BlockedState and timeouts,
+    then each core's RunningState and ReadyState.
+    The structures save themselves in their in-memory layout, so restoring needs no replay and no rehashing.
+*/
+template <class Policy>
+int Process_Manager<Policy>::K()
+{
+    ImageWriter out(checkpointPath);
+    char policyName[16] = {0};
+    strncpy(policyName, Policy::name, sizeof(policyName) - 1);
+    out.value(CHECKPOINT_MAGIC);
+    out.value(CHECKPOINT_VERSION);
+    out.value(policyName);
+    out.value(Policy::levels);
+    out.value(coreCount);
+
+    out.value(Time);
+    out.value(turnaroundTimeSum);
+    out.value(processesCompleted);
+    out.value(totalProcesses);
+    out.value(turnaroundTimes);
+    out.value(waitingTimes);
+    out.value(responseTimes);
+    out.value(policy);
+    out.value(promotions);
+    out.value(starvedDispatches);
+    out.value(longestWait);
+    out.value(ticks);
+    PCB_Table.save(out);
+    BlockedState.save(out);
+    timeouts.save(out);
+    for (int c = 0; c < coreCount; c++)
+    {
+        CoreState &cpu = Cores[c];
+        out.value(cpu.RunningState);
+        out.value(cpu.busyTime);
+        out.value(cpu.turnaroundTimeSum);
+        out.value(cpu.processesCompleted);
+        out.value(cpu.steals);
+        cpu.ReadyState->save(out);
+    }
+    out.value(CHECKPOINT_MAGIC);
+    if (!out.close())
+    {
+        cerr << "could not write checkpoint " << checkpointPath << endl;
+        return 1;
+    }
+    return 0;
+}
+
+//====| Checkpoint |====//
+
+/*
+    Replaces the whole state with the image at path. The core count comes from the image.
+    Returns false (with a message) if the image is missing, truncated, of another version or policy.
+*/
+template <class Policy>
+bool Process_Manager<Policy>::restore(const string &path)
+{
+    ImageReader in(path);
+    unsigned long long magic = 0;
+    int version = 0, levels = 0, cores = 0;
+    char policyName[16] = {0};
+    in.value(magic);
+    in.value(version);
+    in.value(policyName);
+    in.value(levels);
+    in.value(cores);
+    policyName[sizeof(policyName) - 1] = 0;
+    if (!in.good() || magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION)
+    {
+        cerr << path << " is not a version " << CHECKPOINT_VERSION << " checkpoint" << endl;
+        return false;
+    }
+    if (strcmp(policyName, Policy::name) != 0 || levels != Policy::levels || cores < 1)
+    {
+        cerr << path << " was written by the " << policyName << " scheduler, not " << Policy::name << endl;
+        return false;
+    }
+
+    for (int c = 0; c < coreCount; c++)
+    {
+        delete Cores[c].ReadyState;
+    }
+    delete[] Cores;
+    coreCount = cores;
+    Cores = new CoreState[coreCount];
+
+    in.value(Time);
+    in.value(turnaroundTimeSum);
+    in.value(processesCompleted);
+    in.value(totalProcesses);
+    in.value(turnaroundTimes);
+    in.value(waitingTimes);
+    in.value(responseTimes);
+    in.value(policy);
+    in.value(promotions);
+    in.value(starvedDispatches);
+    in.value(longestWait);
+    long long period = ticks.period; // The tick period is this run's setting (-t), not the image's
+    in.value(ticks);
+    ticks.period = period;
+    bool ok = PCB_Table.load(in) && BlockedState.load(in) && timeouts.load(in);
+    for (int c = 0; c < coreCount; c++)
+    {
+        CoreState &cpu = Cores[c];
+        cpu.ReadyState = new typename Policy::ReadyQueue(Policy::levels);
+        in.value(cpu.RunningState);
+        in.value(cpu.busyTime);
+        in.value(cpu.turnaroundTimeSum);
+        in.value(cpu.processesCompleted);
+        in.value(cpu.steals);
+        ok = cpu.ReadyState->load(in) && ok;
+    }
+    magic = 0;
+    in.value(magic);
+    if (!ok || !in.good() || magic != CHECKPOINT_MAGIC || !in.atEnd())
+    {
+        cerr << path << " is damaged or truncated" << endl;
+        return false;
+    }
+    return true;
+}
+
+//====| Helpers |====//
+
+/*
+    Swaps a core's ReadyState and RunningState.
+    done indicates if a process is finished. If process is finished (done), process does not go back to ReadyState.
+    If process is not finsihed (not done), process swaps with ReadyState and RunningState.
+*/
+template <class Policy>
+void Process_Manager<Policy>::swap(int core, bool done)
+{
+    STATS(pmStats.swap++);
+    CoreState &cpu = Cores[core];
+    if (!done) // If process has not completed (Has met quantum), enqueue it
+    {
+        policy.expired(PCB_Table[cpu.RunningState[0]]); // Let the policy adjust the priority since it's met it's quantum
+        traceEvent(TRACE_PREEMPT, core, cpu.RunningState[0], 0);
+        PCB_Table[cpu.RunningState[0]].setReady(Time);
+        policy.enqueue(*cpu.ReadyState, PCB_Table[cpu.RunningState[0]]);
+    }
+
+    updateRunningState(core, nextProcess(core));
+}
+
+/*
+    Puts an unblocked process on core if that core is idle, otherwise queues it there; core -1 picks
+    the first idle core, or the least loaded one if none is idle.
+*/
+template <class Policy>
+void Process_Manager<Policy>::wake(int pid, int core)
+{
+    if (core < 0)
+    {
+        for (int c = 0; c < coreCount && core < 0; c++)
+        {
+            if (Cores[c].RunningState[0] < 1)
+            {
+                core = c;
+            }
+        }
+        if (core < 0)
+        {
+            core = leastLoaded();
+        }
+    }
+    PCB_Table[pid].setReady(Time);
+    if (Cores[core].RunningState[0] < 1)
+    {
+        updateRunningState(core, pid);
+    }
+    else
+    {
+        policy.enqueue(*Cores[core].ReadyState, PCB_Table[pid]);
+    }
+}
+
+/*
+    Unblocks (onto any core) every process whose block deadline is at or before Time, earliest first.
+    Entries without a process (only in images written before B ignored idle cores) just leave the queue.
+*/
+template <class Policy>
+void Process_Manager<Policy>::wakeTimedOut()
+{
+    timeouts.advance(Time, [this](int node)
+                     {
+                         int pid = BlockedState.pidOf(node);
+                         int rid = BlockedState.ridOf(node);
+                         BlockedState.remove(node);
+                         if (pid >= 1)
+                         {
+                             traceEvent(TRACE_TIMEOUT, -1, pid, rid);
+                             wake(pid, -1);
+                         } });
+}
+
+/*
+    Turns on aging (see select) and the starvation count of T, for waits of limit ticks (STARVATION_TICKS if 0).
+*/
+template <class Policy>
+void Process_Manager<Policy>::setAging(int interval, int limit)
+{
+    agingInterval = Policy::ages ? interval : 0;
+    starvationLimit = limit > 0 ? limit : STARVATION_TICKS;
+}
+
+/*
+    A wall-clock tick: advances Time by the timer periods that have passed, like Q(periods), and records how
+    late (in microseconds) the tick was run. Every period past the first expired before the tick was read.
+*/
+template <class Policy>
+int Process_Manager<Policy>::tick(int periods, long long lateness)
+{
+    ticks.quanta += periods;
+    ticks.missed += periods - 1;
+    ticks.lateness.record(lateness);
+    return Q(periods);
+}
+
+/*
+    Parses text input into a Command record (see parseCommand) and runs it. Returns 1 if the command is invalid.
+*/
+template <class Policy>
+int Process_Manager<Policy>::digestInput(string_view input)
+{
+    STATS(pmStats.digestInput++);
+    Command cmd;
+    if (!parseCommand(input, cmd))
+    {
+        return 1;
+    }
+    return digestCommand(cmd);
+}
+
+/*
+    Runs varying commands based on the op and args of a Command record.
+*/
+template <class Policy>
+int Process_Manager<Policy>::digestCommand(const Command &cmd)
+{
+    STATS(int statIndex = Stats::commandIndex(cmd.op);
+          StatTimer timer(pmStats.command[statIndex], &pmStats.latency[statIndex]));
+    switch (cmd.op)
+    {
+    case 'S':
+        return S(cmd.arg[0], cmd.arg[1], cmd.arg[2]);
+    case 'B':
+        return B(cmd.arg[0], cmd.arg[1] < 0 ? 0 : cmd.arg[1], cmd.arg[2]);
+    case 'U':
+        return U(cmd.arg[0], cmd.arg[1]);
+    case 'Q':
+        return Q(cmd.arg[0]);
+    case 'C':
+        return C(cmd.cop, cmd.arg[0], cmd.arg[1] < 0 ? 0 : cmd.arg[1]);
+    case 'P':
+        return P();
+    case 'T':
+        return T();
+    case 'I':
+        return I();
+    case 'K':
+        return K();
+    default:
+        perror("Incorrect Command");
+        exit(1);
+        break;
+    }
+    return 0;
+};
+
+/*
+    Updates the running state of core (and, with real jobs, stops the one leaving it and continues pid's).
+    Time elapsed is for comparing if process has met quantum.
+    The process's waiting time (and, on its first run, response time) is brought up to date, and the wait
+    it ends is checked for starvation.
+*/
+template <class Policy>
+void Process_Manager<Policy>::updateRunningState(int core, int pid)
+{
+    int *RunningState = Cores[core].RunningState;
+    STATS(pmStats.contextSwitches += RunningState[0] != pid);
+    if (jobs != NULL && RunningState[0] != pid)
+    {
+        jobs->dispatch(core, RunningState[0], pid);
+    }
+    PCBHandle h = PCB_Table.find(pid);
+    PCBRef pcb = PCB_Table.get(h);
+    if (PCB_Table.valid(h))
+    {
+        int waited = Time - pcb.getReadySince();
+        longestWait = max(longestWait, waited);
+        starvedDispatches += starvationLimit > 0 && waited >= starvationLimit;
+        pcb.dispatch(Time);
+    }
+    RunningState[0] = pid;                                // Pointer to process is PID
+    RunningState[1] = 0;                                  // Set current time elapsed for process on CPU back to 0
+    RunningState[2] = Policy::quantum[pcb.getPriority()]; // Set quantum based on priority
+    traceEvent(TRACE_DISPATCH, core, pid, RunningState[2]);
+}
+
+/*
+    Records an event at the current Time, with the priority level pid has now.
+*/
+template <class Policy>
+void Process_Manager<Policy>::traceEvent(TraceKind kind, int core, int pid, int arg)
+{
+    if (trace != NULL)
+    {
+        trace->record(Time, kind, core, pid, arg, pid >= 1 ? PCB_Table[pid].getPriority() : 0);
+    }
+}
+
+/*
+    True if core has a queued process, or another core has one it could steal.
+*/
+template <class Policy>
+bool Process_Manager<Policy>::hasReady(int core)
+{
+    for (int c = 0; c < coreCount; c++)
+    {
+        if (Cores[(core + c) % coreCount].ReadyState->QAsize() > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    Dequeues the next process for core (the policy's choice) from its own ReadyState. If that is empty
+    the core steals the policy's choice from the core with the longest ready queue.
+    Returns 0 (no process) if every ready queue is empty.
+*/
+template <class Policy>
+int Process_Manager<Policy>::nextProcess(int core)
+{
+    if (Cores[core].ReadyState->QAsize() > 0)
+    {
+        return select(*Cores[core].ReadyState);
+    }
+    int victim = -1;
+    for (int c = 0; c < coreCount; c++)
+    {
+        if (Cores[c].ReadyState->QAsize() > 0 && (victim < 0 || Cores[c].ReadyState->QAsize() > Cores[victim].ReadyState->QAsize()))
+        {
+            victim = c;
+        }
+    }
+    if (victim < 0)
+    {
+        return 0;
+    }
+    Cores[core].steals++;
+    return select(*Cores[victim].ReadyState);
+}
+
+/*
+    Lazy aging: rather than moving waiting processes up the queues as time passes, a queued process is
+    treated as if it had risen one level for every agingInterval ticks since it became ready. A level's queue
+    is in ready_since order, so its front is its longest waiter and ranks best among that level's processes;
+    comparing the fronts' effective levels finds the process to run in O(levels), however many are queued.
+    The winner is dequeued and moved up to its effective level for real (so it also gets that quantum). Ties
+    go to the process that reached that level first (ready_since plus the intervals it took to rise), just as
+    if promoted processes had joined the back of the higher queue when their interval ran out.
+*/
+template <class Policy>
+int Process_Manager<Policy>::select(typename Policy::ReadyQueue &ready)
+{
+    if constexpr (Policy::ages)
+    {
+        if (agingInterval > 0)
+        {
+            int best = -1, bestLevel = Policy::levels;
+            long long bestArrival = 0; // When the best candidate reached bestLevel
+            for (int level = 0; level < Policy::levels; level++)
+            {
+                if (ready.Qsize(level) > 0)
+                {
+                    int readySince = PCB_Table[*ready.Qview(level).begin()].getReadySince();
+                    int effective = max(0, level - (Time - readySince) / agingInterval);
+                    long long arrival = readySince + (long long)(level - effective) * agingInterval;
+                    if (effective < bestLevel || (effective == bestLevel && arrival < bestArrival))
+                    {
+                        best = level;
+                        bestLevel = effective;
+                        bestArrival = arrival;
+                    }
+                }
+            }
+            if (best < 0)
+            {
+                return 0;
+            }
+            int pid = ready.Dequeue(best);
+            if (bestLevel < best)
+            {
+                PCB_Table[pid].setPriority(bestLevel);
+                promotions += best - bestLevel;
+            }
+            return pid;
+        }
+    }
+    return policy.select(ready);
+}
+
+/*
+    Core with the fewest queued (and running) processes; the lowest numbered one on a tie.
+*/
+template <class Policy>
+int Process_Manager<Policy>::leastLoaded()
+{
+    int best = 0, bestLoad = -1;
+    for (int c = 0; c < coreCount; c++)
+    {
+        int load = Cores[c].ReadyState->QAsize() + (Cores[c].RunningState[0] >= 1);
+        if (bestLoad < 0 || load < bestLoad)
+        {
+            best = c;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+#endif
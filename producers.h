@@ -0,0 +1,328 @@
+#ifndef PRODUCERS_H
+#define PRODUCERS_H
+/*
+    Command producers for processManager.
+    Any number of commander front ends can feed one manager: the pipe inherited from the spawning commander,
+    plus every connection accepted on an optional Unix socket. Each connection is owned by one of a few
+    I/O threads that multiplex their connections with epoll, decode whole Command records from non-blocking
+    reads and push them onto one MPSCRing that the scheduler consumes. A connection is only ever read by one
+    thread, so each producer's commands keep their order; different producers interleave.
+    In real-time mode a TickClock's timerfd joins worker 0's epoll set, and its expirations are pushed onto
+    the same ring as TICK records between the commands.
+*/
+//====| STL Includes |====//
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//====| Local Includes |====//
+#include "command.h"
+#include "mpsc_ring.h"
+#include "tick_clock.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define PRODUCER_RING 65536 // Commands buffered between the I/O threads and the scheduler
+#define PRODUCER_EVENTS 64  // epoll events handled per wakeup
+
+//====| Class Declaration |====//
+class ProducerLoop
+{
+private:
+    /*
+        One producer: a non-blocking descriptor and the bytes of a partially received record.
+    */
+    struct Connection
+    {
+        int fd;
+        size_t bytes;
+        Command buffer[COMMAND_BATCH];
+    };
+
+    /*
+        One I/O thread and its epoll instance. wake is an eventfd used to stop the thread.
+    */
+    struct Worker
+    {
+        int epfd;
+        int wake;
+        thread io;
+    };
+
+    MPSCRing<Command> &ring;
+    Worker *workers;
+    int workerCount;
+    int nextWorker;         // Round robin assignment of new connections
+    int listenFd;           // -1 unless listening on a socket
+    TickClock *ticker;      // NULL unless in real-time mode
+    string socketPath;
+    atomic<int> producers;  // Producers still connected
+    atomic<bool> stopping;
+    mutex connectionLock;
+    vector<Connection *> connections; // Every open connection, so they can be released on shutdown
+
+    void run(int);
+    void attach(int fd);                   // Hands fd to the next worker
+    void detach(int epfd, Connection *);   // Closes and frees a connection
+    bool drain(Connection *);              // Reads and pushes what is available; false on end of stream
+    void acceptAll();
+
+public:
+    //----| Constructor(s) |----//
+    ProducerLoop(MPSCRing<Command> &queue, int threads);
+    ~ProducerLoop();
+
+    //----| Helpers |----//
+    void add(int fd);                 // Adds an already connected producer (e.g. the commander pipe)
+    bool listen(const char *path);    // Accepts producers on a Unix socket until stopped
+    void addTicker(TickClock &clock); // Pushes a TICK record whenever the armed clock expires
+    void start();
+    void stop();
+};
+
+//====| Class Definitions |====//
+
+inline ProducerLoop::ProducerLoop(MPSCRing<Command> &queue, int threads) : ring(queue), workerCount(threads), nextWorker(0),
+                                                                    listenFd(-1), ticker(NULL), producers(0), stopping(false)
+{
+    workers = new Worker[workerCount];
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers[i].epfd = epoll_create1(EPOLL_CLOEXEC);
+        workers[i].wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (workers[i].epfd < 0 || workers[i].wake < 0)
+        {
+            perror("unable to create the event loop");
+            exit(1);
+        }
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL; // NULL marks the wake eventfd
+        epoll_ctl(workers[i].epfd, EPOLL_CTL_ADD, workers[i].wake, &ev);
+    }
+}
+
+inline ProducerLoop::~ProducerLoop()
+{
+    stop();
+    for (Connection *conn : connections)
+    {
+        close(conn->fd);
+        delete conn;
+    }
+    for (int i = 0; i < workerCount; i++)
+    {
+        close(workers[i].epfd);
+        close(workers[i].wake);
+    }
+    delete[] workers;
+}
+
+inline void ProducerLoop::add(int fd)
+{
+    producers++;
+    attach(fd);
+}
+
+/*
+    Creates, binds and listens on a Unix socket at path (replacing a stale socket file).
+    The listening socket lives on worker 0; accepted connections are spread over all workers.
+*/
+inline bool ProducerLoop::listen(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(path);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) || ::listen(listenFd, 64))
+    {
+        perror("unable to listen for commanders");
+        return false;
+    }
+    socketPath = path;
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = &listenFd;
+    epoll_ctl(workers[0].epfd, EPOLL_CTL_ADD, listenFd, &ev);
+    return true;
+}
+
+/*
+    The clock is not a producer: it does not keep the stream open once every producer is gone.
+*/
+inline void ProducerLoop::addTicker(TickClock &clock)
+{
+    ticker = &clock;
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = ticker;
+    epoll_ctl(workers[0].epfd, EPOLL_CTL_ADD, clock.descriptor(), &ev);
+}
+
+inline void ProducerLoop::start()
+{
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers[i].io = thread(&ProducerLoop::run, this, i);
+    }
+}
+
+/*
+    Stops and joins the I/O threads. Commands still in flight are dropped.
+*/
+inline void ProducerLoop::stop()
+{
+    if (stopping.exchange(true))
+    {
+        return;
+    }
+    ring.close();
+    for (int i = 0; i < workerCount; i++)
+    {
+        unsigned long long one = 1;
+        write(workers[i].wake, &one, sizeof(one));
+    }
+    for (int i = 0; i < workerCount; i++)
+    {
+        if (workers[i].io.joinable())
+        {
+            workers[i].io.join();
+        }
+    }
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+}
+
+//----| Helpers |----//
+
+inline void ProducerLoop::attach(int fd)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    Connection *conn = new Connection;
+    conn->fd = fd;
+    conn->bytes = 0;
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.ptr = conn;
+    lock_guard<mutex> guard(connectionLock);
+    connections.push_back(conn);
+    Worker &w = workers[nextWorker];
+    nextWorker = (nextWorker + 1) % workerCount;
+    epoll_ctl(w.epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+inline void ProducerLoop::detach(int epfd, Connection *conn)
+{
+    epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    {
+        lock_guard<mutex> guard(connectionLock);
+        connections.erase(find(connections.begin(), connections.end(), conn));
+    }
+    delete conn;
+}
+
+/*
+    Event loop of one I/O thread.
+*/
+inline void ProducerLoop::run(int index)
+{
+    Worker &w = workers[index];
+    struct epoll_event events[PRODUCER_EVENTS];
+    while (!stopping.load())
+    {
+        int n = epoll_wait(w.epfd, events, PRODUCER_EVENTS, -1);
+        for (int i = 0; i < n && !stopping.load(); i++)
+        {
+            if (events[i].data.ptr == NULL)
+            {
+                continue; // Woken to stop
+            }
+            if (events[i].data.ptr == &listenFd)
+            {
+                acceptAll();
+                continue;
+            }
+            if (events[i].data.ptr == ticker)
+            {
+                Command tick;
+                if (ticker->expire(tick))
+                {
+                    ring.push(tick);
+                }
+                continue;
+            }
+            Connection *conn = (Connection *)events[i].data.ptr;
+            if (!drain(conn))
+            {
+                detach(w.epfd, conn);
+                if (--producers == 0 && listenFd < 0) // Last producer gone and no one else can connect
+                {
+                    Command end;
+                    memset(&end, 0, sizeof(end));
+                    end.op = END_OF_STREAM;
+                    ring.push(end);
+                }
+            }
+        }
+    }
+}
+
+inline void ProducerLoop::acceptAll()
+{
+    int fd;
+    while ((fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC)) >= 0)
+    {
+        add(fd);
+    }
+}
+
+/*
+    Reads one buffer's worth from the connection and pushes every whole record onto the ring.
+    A trailing partial record is kept for the next read. Returns false at end of stream or on error.
+*/
+inline bool ProducerLoop::drain(Connection *conn)
+{
+    ssize_t n = read(conn->fd, (char *)conn->buffer + conn->bytes, sizeof(conn->buffer) - conn->bytes);
+    if (n < 0)
+    {
+        return errno == EAGAIN || errno == EINTR;
+    }
+    if (n == 0)
+    {
+        return false;
+    }
+    conn->bytes += n;
+    size_t records = conn->bytes / sizeof(Command);
+    for (size_t i = 0; i < records; i++)
+    {
+        if (!ring.push(conn->buffer[i]))
+        {
+            return false; // Shutting down
+        }
+    }
+    size_t used = records * sizeof(Command);
+    conn->bytes -= used;
+    memmove(conn->buffer, (char *)conn->buffer + used, conn->bytes);
+    return true;
+}
+
+#endif
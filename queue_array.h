@@ -10,7 +10,11 @@
 #include <cstdlib> //This is for the exit command.
 
 #include <iostream>
-#include <queue>
+#include <deque>
+#include <vector>
+
+#include "stats.h"
+#include "image.h"
 
 using namespace std;
 
@@ -30,16 +34,49 @@ public:
   ~QueueArray();
   int Asize();
   T Dequeue();
+  T Dequeue(int index);
   int Enqueue(const T &item, const int index);
   int QAsize();
   int Qsize(int index);
-  T *Qstate(int index);
+  class View;
+  View Qview(int index) const;
+  void save(ImageWriter &out) const;
+  bool load(ImageReader &in);
+
+private:
+  int size;                    // size of the array
+  deque<T> *array;             // the array of queues (deques, so a level can be read in place).  It must be an array (NO not a vector)
+  int totalItems;              // total number of items stored in the queues
+  int words;                   // number of 64-bit words in bitmap
+  int summaryWords;            // number of 64-bit words in summary
+  unsigned long long *bitmap;  // bit i is set while queue i is non-empty
+  unsigned long long *summary; // bit w is set while bitmap[w] is non-zero
+  bool inRange(int index) const;
+  void markNonEmpty(int index);
+  void markEmpty(int index);
+  int firstNonEmpty();
+};
+
+//==== View ====//
+
+/*
+Iterable range over one queue of the array, usable in a range-based for loop.
+*/
+template <class T>
+class QueueArray<T>::View
+{
+public:
+  typedef typename deque<T>::const_iterator const_iterator;
+  View() : first(), last() {}
+  View(const_iterator b, const_iterator e) : first(b), last(e) {}
+  const_iterator begin() const { return first; }
+  const_iterator end() const { return last; }
+  int size() const { return last - first; }
+  bool empty() const { return first == last; }
 
 private:
-  int size;        // size of the array
-  queue<T> *array; // the array of queues.  It must be an array (NO not a vector)
-  int totalItems;  // total number of items stored in the queues
-  bool inRange(int index);
+  const_iterator first;
+  const_iterator last;
 };
 
 //==== Public ====//
@@ -49,7 +86,10 @@ private:
 // Constructor for the queue array.  It sets the default size
 // to 10, initializes the private variables size and totalItems
 template <class T>
-QueueArray<T>::QueueArray(int sz) : size(sz), totalItems(0), array(new queue<T>[size])
+QueueArray<T>::QueueArray(int sz) : size(sz), array(new deque<T>[size]), totalItems(0),
+                                    words((sz + 63) / 64), summaryWords((words + 63) / 64),
+                                    bitmap(new unsigned long long[words]()),
+                                    summary(new unsigned long long[summaryWords]())
 {
   if (array == NULL)
   {
@@ -67,6 +107,8 @@ template <class T>
 QueueArray<T>::~QueueArray()
 {
   delete[] array;
+  delete[] bitmap;
+  delete[] summary;
 }
 
 //---- Setters ----//
@@ -79,14 +121,17 @@ otherwise
 template <class T>
 int QueueArray<T>::Enqueue(const T &item, const int index)
 {
+  STATS(pmStats.enqueue++);
   if (!inRange(index))
   {
     return -1;
   }
   try
   {
-    array[index].emplace(item); // Warning: May be better to use push() instead. . .
+    array[index].emplace_back(item); // Warning: May be better to use push() instead. . .
     totalItems++;
+    markNonEmpty(index);
+    STATS(pmStats.depth(index, array[index].size()));
   }
   catch (exception &e)
   {
@@ -133,43 +178,109 @@ int QueueArray<T>::QAsize()
 Dequeues an item from the first non-empty queue in the array,
 i.e., from the non-empty queue at the lowest numbered index in the array. Returns
 the dequeued item, if there is at least one item in the queue array; 0 otherwise.
+The queue is found through the bitmap, so the cost does not grow with Asize.
 */
 template <class T>
 T QueueArray<T>::Dequeue()
 {
-  for (int i = 0; i < Asize(); i++)
+  STATS(pmStats.dequeue++);
+  int i = firstNonEmpty();
+  if (i < 0)
   {
-    if (array[i].size() >= 1)
-    {
-      T val = array[i].front();
-      array[i].pop();
-      totalItems--;
-      return val;
-    }
+    return 0;
+  }
+  T val = array[i].front();
+  array[i].pop_front();
+  totalItems--;
+  if (array[i].empty())
+  {
+    markEmpty(i);
+  }
+  return val;
+}
+
+/*
+Dequeues an item from the queue at array index index. Returns the dequeued item,
+if that queue is not empty; 0 otherwise (also if index is out of range).
+*/
+template <class T>
+T QueueArray<T>::Dequeue(int index)
+{
+  STATS(pmStats.dequeue++);
+  if (!inRange(index) || array[index].empty())
+  {
+    return 0;
+  }
+  T val = array[index].front();
+  array[index].pop_front();
+  totalItems--;
+  if (array[index].empty())
+  {
+    markEmpty(index);
   }
-  return 0;
+  return val;
 }
 
 /*
-Copies all items stored in the queue at array index index
-in an array. Returns a pointer to this array; NULL, if index is out of range.
+Returns a read-only view of the queue at array index index, front to back.
+Nothing is copied or allocated, and the queue is not modified; an empty view, if index is out of range.
+The view is invalidated by the next Enqueue or Dequeue.
 */
 template <class T>
-T *QueueArray<T>::Qstate(int index)
+typename QueueArray<T>::View QueueArray<T>::Qview(int index) const
 {
   if (!inRange(index))
   {
-    return NULL;
+    return View();
   }
-  T *q = new T[array[index].size()];
-  for (int i = 0; i < array[index].size(); i++)
+  return View(array[index].begin(), array[index].end());
+}
+
+/*
+Writes every queue, front to back, to a checkpoint image.
+*/
+template <class T>
+void QueueArray<T>::save(ImageWriter &out) const
+{
+  out.value(size);
+  vector<T> items;
+  for (int i = 0; i < size; i++)
   {
-    T val = array[index].front();
-    q[i] = val;
-    array[index].pop();
-    array[index].emplace(val);
+    items.assign(array[i].begin(), array[i].end());
+    out.array(items);
   }
-  return q;
+}
+
+/*
+Replaces the contents of every queue with the ones saved in a checkpoint image.
+Returns false if the image does not hold a queue array of the same size.
+*/
+template <class T>
+bool QueueArray<T>::load(ImageReader &in)
+{
+  int saved = 0;
+  in.value(saved);
+  if (saved != size)
+  {
+    return false;
+  }
+  vector<T> items;
+  totalItems = 0;
+  for (int i = 0; i < size; i++)
+  {
+    in.array(items);
+    array[i].assign(items.begin(), items.end());
+    totalItems += items.size();
+    if (items.empty())
+    {
+      markEmpty(i);
+    }
+    else
+    {
+      markNonEmpty(i);
+    }
+  }
+  return in.good();
 }
 
 //==== Private ====//
@@ -180,9 +291,52 @@ T *QueueArray<T>::Qstate(int index)
 Takes an index and returns true if: 0 <= index < Asize (if index is in range).
 */
 template <class T>
-bool QueueArray<T>::inRange(int index)
+bool QueueArray<T>::inRange(int index) const
 {
-  return index >= 0 && index < Asize();
+  return index >= 0 && index < size;
+}
+
+/*
+Sets the bit for queue index (and its word in the summary).
+*/
+template <class T>
+void QueueArray<T>::markNonEmpty(int index)
+{
+  int w = index >> 6;
+  bitmap[w] |= 1ULL << (index & 63);
+  summary[w >> 6] |= 1ULL << (w & 63);
+}
+
+/*
+Clears the bit for queue index, and its summary bit once the whole word is empty.
+*/
+template <class T>
+void QueueArray<T>::markEmpty(int index)
+{
+  int w = index >> 6;
+  bitmap[w] &= ~(1ULL << (index & 63));
+  if (bitmap[w] == 0)
+  {
+    summary[w >> 6] &= ~(1ULL << (w & 63));
+  }
+}
+
+/*
+Returns the lowest index of a non-empty queue; -1 if every queue is empty.
+Two count-trailing-zeros lookups cover up to 4096 queues with a single summary word.
+*/
+template <class T>
+int QueueArray<T>::firstNonEmpty()
+{
+  for (int s = 0; s < summaryWords; s++)
+  {
+    if (summary[s])
+    {
+      int w = (s << 6) + __builtin_ctzll(summary[s]);
+      return (w << 6) + __builtin_ctzll(bitmap[w]);
+    }
+  }
+  return -1;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef REPORT_BUFFER_H
+#define REPORT_BUFFER_H
+/*
+    Output buffer of the reporter thread.
+    A whole report is formatted into one char buffer (integers with to_chars, doubles the way ostream prints
+    them by default, padding done by hand) and handed to the kernel with a single write(), instead of going
+    through cout with a flush at every endl. The buffer keeps its capacity between reports, so once it has
+    grown to fit the largest report it is never reallocated.
+*/
+//====| STL Includes |====//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unistd.h>
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define REPORT_BUFFER (1 << 16) // Initial capacity; grows to the largest report
+
+//====| Class Declaration |====//
+class ReportBuffer
+{
+private:
+    char *data;
+    size_t used;
+    size_t capacity;
+
+    /*
+        Makes room for extra more bytes.
+    */
+    char *reserve(size_t extra)
+    {
+        if (used + extra > capacity)
+        {
+            while (used + extra > capacity)
+            {
+                capacity *= 2;
+            }
+            data = (char *)realloc(data, capacity);
+        }
+        return data + used;
+    }
+
+    /*
+        Appends s padded with spaces to width (on the right if leftAlign, like setw and left).
+    */
+    void pad(string_view s, int width, bool leftAlign)
+    {
+        int fill = width > (int)s.size() ? width - (int)s.size() : 0;
+        char *out = reserve(s.size() + fill);
+        if (!leftAlign)
+        {
+            memset(out, ' ', fill);
+            out += fill;
+        }
+        memcpy(out, s.data(), s.size());
+        if (leftAlign)
+        {
+            memset(out + s.size(), ' ', fill);
+        }
+        used += s.size() + fill;
+    }
+
+    /*
+        Formats an integer or double into buffer (24 bytes) and returns its text.
+    */
+    template <class T>
+    static string_view format(T value, char *buffer)
+    {
+        if constexpr (is_floating_point<T>::value)
+        {
+            return string_view(buffer, snprintf(buffer, 24, "%g", (double)value)); // ostream's default: 6 significant digits
+        }
+        else
+        {
+            return string_view(buffer, to_chars(buffer, buffer + 24, value).ptr - buffer);
+        }
+    }
+
+public:
+    //----| Constructor(s) |----//
+    ReportBuffer(size_t initial = REPORT_BUFFER) : data((char *)malloc(initial)), used(0), capacity(initial) {}
+    ~ReportBuffer() { free(data); }
+    ReportBuffer(const ReportBuffer &) = delete;
+    ReportBuffer &operator=(const ReportBuffer &) = delete;
+
+    //----| Appending |----//
+    ReportBuffer &operator<<(string_view s)
+    {
+        memcpy(reserve(s.size()), s.data(), s.size());
+        used += s.size();
+        return *this;
+    }
+    ReportBuffer &operator<<(const char *s) { return *this << string_view(s); }
+    ReportBuffer &operator<<(const string &s) { return *this << string_view(s); }
+    ReportBuffer &operator<<(char c)
+    {
+        *reserve(1) = c;
+        used++;
+        return *this;
+    }
+    template <class T, class = typename enable_if<is_arithmetic<T>::value>::type>
+    ReportBuffer &operator<<(T value)
+    {
+        char buffer[24];
+        return *this << format(value, buffer);
+    }
+
+    /*
+        Appends value padded to width, right-aligned unless leftAlign (setw(width) << value).
+    */
+    template <class T>
+    ReportBuffer &field(T value, int width, bool leftAlign = false)
+    {
+        if constexpr (is_arithmetic<T>::value)
+        {
+            char buffer[24];
+            pad(format(value, buffer), width, leftAlign);
+        }
+        else
+        {
+            pad(string_view(value), width, leftAlign);
+        }
+        return *this;
+    }
+
+    //----| Output |----//
+    size_t size() const { return used; }
+
+    /*
+        Writes the whole buffer to fd (one write() unless the kernel takes it in parts) and empties it.
+        Returns false if write() fails.
+    */
+    bool flush(int fd)
+    {
+        const char *out = data;
+        size_t left = used;
+        used = 0;
+        while (left > 0)
+        {
+            ssize_t n = write(fd, out, left);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            out += n;
+            left -= n;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,584 @@
+#ifndef REPORTER_H
+#define REPORTER_H
+/*
+    Reporter thread for the P and T commands.
+    The scheduler copies just the rows it needs into a Snapshot and hands it over; the reporter thread
+    formats and prints it while the scheduler goes on consuming commands. Two Snapshot buffers are
+    used in turn (double buffering), and their vectors keep their capacity, so once warmed up a report
+    costs one pass over the queued PIDs and no allocation, fork() or wait() on the scheduler side.
+    The reporter formats each report into a ReportBuffer and writes it to standard output with one write(),
+    either in the original text layout or (REPORT_JSON, processManager -o json) as one compact JSON object
+    per line for monitoring tools.
+*/
+//====| STL Includes |====//
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//====| Local Includes |====//
+#include "PCB.h"
+#include "stats.h"
+#include "latency_histogram.h"
+#include "report_buffer.h"
+#include "tick_clock.h"
+#include "job_control.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Snapshot |====//
+
+enum ReportFormat
+{
+    REPORT_TEXT, // The original layout
+    REPORT_JSON, // One JSON object per report, on one line
+};
+
+/*
+    One printed row of the PCB table.
+*/
+struct PCBRow
+{
+    int pid;
+    int priority;
+    int value;
+    int start_time;
+    int cpu_time;
+
+    template <class P>
+    static PCBRow of(const P &pcb)
+    {
+        return PCBRow{pcb.getPID(), pcb.getPriority(), pcb.getValue(), pcb.getStart(), pcb.getCPU()};
+    }
+};
+
+/*
+    Statistics of one core for the T report.
+*/
+struct CoreRow
+{
+    double busyTime;
+    double turnaroundTimeSum;
+    double processesCompleted;
+    double steals;
+};
+
+/*
+    Aging and starvation figures for the T report (starvationLimit 0: not asked for).
+*/
+struct AgingRow
+{
+    int interval;
+    int starvationLimit;
+    long long promotions;
+    long long starved;
+    int longestWait;   // Longest wait that ended in a dispatch
+    int longestQueued; // Longest wait of a process still queued
+};
+
+/*
+    Consistent copy of everything one report prints.
+    kind 'P': running holds one row per core; rows holds the queued PCBs of each resource in resourceIds and then of each
+    priority level of each core, and counts gives the number of rows in each of those groups, in print order.
+    kind 'T': the turnaround totals and distributions, with more than one core coreStats, in real-time mode ticks, with real jobs jobs,
+    and with -a or -W aging.
+    kind 'I': stats, if statsEnabled.
+*/
+struct Snapshot
+{
+    char kind;
+    int Time;
+    int cores;
+    int resources;
+    vector<int> resourceIds;
+    int levels;
+    vector<PCBRow> running;
+    vector<int> counts;
+    vector<PCBRow> rows;
+    double turnaroundTimeSum;
+    double processesCompleted;
+    LatencyHistogram turnaroundTimes;
+    LatencyHistogram waitingTimes;
+    LatencyHistogram responseTimes;
+    vector<CoreRow> coreStats;
+    TickStats ticks;
+    JobStats jobs;
+    AgingRow aging;
+    bool statsEnabled;
+    Stats stats;
+};
+
+//====| Class Declaration |====//
+class Reporter
+{
+private:
+    Snapshot buffers[2];
+    bool pending[2];  // Published and not yet printed
+    int fillIndex;    // Buffer the scheduler fills next
+    int printIndex;   // Buffer the reporter prints next
+    bool stopping;
+    ReportFormat format;
+    ReportBuffer out; // Reporter thread only
+    mutex lock;
+    condition_variable changed;
+    thread worker;
+
+    void run();
+    void print(const Snapshot &);
+    void printRow(const PCBRow &);
+    void printStats(const Snapshot &);
+    void printDistribution(const char *, const LatencyHistogram &);
+    void printJSON(const Snapshot &);
+    void jsonRows(const PCBRow *, int);
+    void jsonDistribution(const char *, const LatencyHistogram &);
+
+public:
+    //----| Constructor(s) |----//
+    Reporter();
+    ~Reporter();
+
+    //----| Helpers |----//
+    void setFormat(ReportFormat f) { format = f; } // Before the first publish
+    Snapshot &acquire(); // Waits for a free buffer and returns it for the scheduler to fill
+    void publish();      // Hands the acquired buffer to the reporter thread
+    void stop();         // Prints everything published so far, then joins the thread
+};
+
+//====| Class Definitions |====//
+
+inline Reporter::Reporter() : fillIndex(0), printIndex(0), stopping(false), format(REPORT_TEXT)
+{
+    pending[0] = pending[1] = false;
+    worker = thread(&Reporter::run, this);
+}
+
+inline Reporter::~Reporter()
+{
+    stop();
+}
+
+/*
+    Only blocks if the reporter is still printing both earlier snapshots.
+*/
+inline Snapshot &Reporter::acquire()
+{
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this]
+                 { return !pending[fillIndex]; });
+    return buffers[fillIndex];
+}
+
+inline void Reporter::publish()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        pending[fillIndex] = true;
+        fillIndex ^= 1;
+    }
+    changed.notify_all();
+}
+
+inline void Reporter::stop()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        if (stopping)
+        {
+            return;
+        }
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+/*
+    Prints snapshots in the order they were published until stopped and drained.
+*/
+inline void Reporter::run()
+{
+    unique_lock<mutex> guard(lock);
+    while (true)
+    {
+        changed.wait(guard, [this]
+                     { return pending[printIndex] || stopping; });
+        if (!pending[printIndex])
+        {
+            return; // Stopping and nothing left to print
+        }
+        guard.unlock();
+        if (format == REPORT_JSON)
+        {
+            printJSON(buffers[printIndex]);
+        }
+        else
+        {
+            print(buffers[printIndex]);
+        }
+        out.flush(STDOUT_FILENO);
+        guard.lock();
+        pending[printIndex] = false;
+        printIndex ^= 1;
+        changed.notify_all();
+    }
+}
+
+/*
+    Formats one snapshot exactly the way the forked reporter used to.
+*/
+inline void Reporter::print(const Snapshot &snap)
+{
+    if (snap.kind == 'I')
+    {
+        printStats(snap);
+        return;
+    }
+    if (snap.kind == 'T')
+    {
+        out << "The average Turnaround Time: " << (snap.processesCompleted ? snap.turnaroundTimeSum / snap.processesCompleted : snap.processesCompleted) << "\n\n";
+        out << "Extra information you might want to know:\n";
+        out << snap.processesCompleted << " processes finished in a total of " << snap.turnaroundTimeSum << " seconds\n";
+        out << "\nTime distributions over finished processes:\n"
+            << "               p50       p90       p99       max\n";
+        printDistribution("Turnaround", snap.turnaroundTimes);
+        printDistribution("Waiting", snap.waitingTimes);
+        printDistribution("Response", snap.responseTimes);
+        if (snap.cores > 1)
+        {
+            out << "\nPer-core statistics:\n";
+            for (int c = 0; c < snap.cores; c++)
+            {
+                const CoreRow &core = snap.coreStats[c];
+                out << "Core " << c << ": utilization " << (snap.Time ? 100 * core.busyTime / snap.Time : 0) << "%, "
+                    << core.processesCompleted << " processes finished, average turnaround "
+                    << (core.processesCompleted ? core.turnaroundTimeSum / core.processesCompleted : 0) << ", "
+                    << core.steals << " steals\n";
+            }
+        }
+        if (snap.ticks.period > 0)
+        {
+            out << "\nReal-time ticks every " << snap.ticks.period << " us: " << snap.ticks.quanta << " quanta, "
+                << snap.ticks.missed << " missed\n"
+                << "               p50       p90       p99       max\n";
+            printDistribution("Late (us)", snap.ticks.lateness);
+        }
+        if (snap.aging.starvationLimit > 0)
+        {
+            out << "\nAging: ";
+            if (snap.aging.interval > 0)
+            {
+                out << "one level per " << snap.aging.interval << " ticks waited, " << snap.aging.promotions << " levels gained\n";
+            }
+            else
+            {
+                out << "off\n";
+            }
+            out << "Starvation: " << snap.aging.starved << " dispatches after waiting " << snap.aging.starvationLimit
+                << "+ ticks, longest wait " << snap.aging.longestWait << " (still queued: " << snap.aging.longestQueued << ")\n";
+        }
+        if (snap.jobs.launched > 0)
+        {
+            out << "\nReal jobs: " << snap.jobs.launched << " launched, " << snap.jobs.cpuMillis
+                << " ms CPU used by the finished ones, " << snap.jobs.switches << " context switches, each costing\n"
+                << "               p50       p90       p99       max\n";
+            printDistribution("Cost (ns)", snap.jobs.switchCost);
+        }
+        return;
+    }
+
+    const char *header = "PID  Priority Value  Start Time  Total CPU time\n";
+    const PCBRow *row = snap.rows.data();
+    int group = 0;
+
+    out << "*****************************************************\nThe current system state is as follows : \n*****************************************************\n \n";
+    out << "CURRENT TIME: " << snap.Time << "\n\n";
+
+    for (int c = 0; c < snap.cores; c++)
+    {
+        out << "RUNNING PROCESS";
+        if (snap.cores > 1)
+        {
+            out << " ON CORE " << c;
+        }
+        out << ":\n"
+            << header;
+        printRow(snap.running[c]);
+        out << '\n';
+    }
+
+    out << "BLOCKED PROCESS:\n";
+    for (int i = 0; i < snap.resources; i++)
+    {
+        int rsize = snap.counts[group++];
+        out << "Queue of processes Blocked for resource " << snap.resourceIds[i] << (rsize == 0 ? " is empty\n" : ":\n");
+        if (rsize > 0)
+        {
+            out << header;
+        }
+        for (int k = 0; k < rsize; k++, row++)
+        {
+            printRow(*row);
+        }
+    }
+
+    out << '\n';
+
+    for (int c = 0; c < snap.cores; c++)
+    {
+        out << "PROCESSES READY TO EXECUTE";
+        if (snap.cores > 1)
+        {
+            out << " ON CORE " << c;
+        }
+        out << ":\n";
+        for (int i = 0; i < snap.levels; i++)
+        {
+            int size = snap.counts[group++];
+            out << "Queue of processes with priority " << i << ((size == 0) ? " is empty\n" : ":\n");
+            if (size > 0)
+            {
+                out << header;
+            }
+            for (int k = 0; k < size; k++, row++)
+            {
+                printRow(*row);
+            }
+        }
+    }
+    out << "*****************************************************\n\n";
+}
+
+/*
+    Same columns as printPCB in PCB.h.
+*/
+inline void Reporter::printRow(const PCBRow &row)
+{
+    out.field(row.pid, 2) << "  ";
+    out.field(row.priority, 4) << "  ";
+    out.field(row.value, 7) << "  ";
+    out.field(row.start_time, 11) << "  ";
+    out.field(row.cpu_time, 8) << '\n';
+}
+
+/*
+    Prints the I report: per-command counts and latencies, hot-path call counts,
+    context switches and the queue depth high-water marks.
+*/
+inline void Reporter::printStats(const Snapshot &snap)
+{
+    out << "*****************************************************\nHot-path statistics:\n*****************************************************\n";
+    if (!snap.statsEnabled)
+    {
+        out << "Statistics are compiled out (build with make STATS=-DPM_STATS)\n\n";
+        return;
+    }
+    const Stats &stats = snap.stats;
+    double ns = stats.nanosPerTick();
+
+    out << "Command     Count   Avg(ns)   p50(ns)   p99(ns)\n";
+    for (int i = 0; i < (int)sizeof(STATS_COMMANDS); i++)
+    {
+        const StatCounter &c = stats.command[i];
+        if (c.calls == 0)
+        {
+            continue;
+        }
+        char name[2] = {STATS_COMMANDS[i], 0};
+        out.field(i < (int)sizeof(STATS_COMMANDS) - 1 ? name : "other", 7, true);
+        out.field(c.calls, 9);
+        out.field((long long)(c.timed ? c.ticks * ns / c.timed : 0), 10);
+        out.field((long long)(stats.latency[i].percentile(0.50) * ns), 10);
+        out.field((long long)(stats.latency[i].percentile(0.99) * ns), 10) << '\n';
+    }
+
+    const char *names[] = {"digestInput", "Q", "swap", "Dequeue", "Enqueue"};
+    const unsigned long long *calls[] = {&stats.digestInput, &stats.Q, &stats.swap, &stats.dequeue, &stats.enqueue};
+    out << "\nHot path          Calls\n";
+    for (int i = 0; i < 5; i++)
+    {
+        out.field(names[i], 12, true);
+        out.field(*calls[i], 11) << '\n';
+    }
+
+    out << "\nContext switches: " << stats.contextSwitches << "\nQueue depth high-water mark by level:";
+    for (int level = 0; level < STATS_LEVELS; level++)
+    {
+        if (stats.depthHighWater[level] > 0)
+        {
+            out << " " << level << ":" << stats.depthHighWater[level];
+        }
+    }
+    out << "\n*****************************************************\n\n";
+}
+
+/*
+    Prints one line of the T report's time distributions: p50, p90, p99 and max.
+*/
+inline void Reporter::printDistribution(const char *name, const LatencyHistogram &times)
+{
+    out.field(name, 10, true);
+    out.field(times.percentile(0.50), 10);
+    out.field(times.percentile(0.90), 10);
+    out.field(times.percentile(0.99), 10);
+    out.field(times.max(), 10) << '\n';
+}
+
+//====| JSON |====//
+
+/*
+    One line per report. PCB rows are arrays in the order of "columns", so a state dump of many thousands
+    of PCBs stays compact:
+        {"kind":"P","time":..,"columns":[..],"running":[row per core],
+         "blocked":[{"resource":rid,"processes":[rows]}..],"ready":[[[rows of level 0]..] per core]}
+        {"kind":"T","time":..,"completed":..,"turnaround_sum":..,"average_turnaround":..,
+         "turnaround":{"p50":..,"p90":..,"p99":..,"max":..},"waiting":{..},"response":{..},"cores":[..],
+         "ticks":{"period_us":..,"quanta":..,"missed":..,"late_us":{..}} (real-time mode only),
+         "jobs":{"launched":..,"cpu_ms":..,"switches":..,"switch_ns":{..}} (real jobs only),
+         "aging":{"interval":..,"promotions":..,"starvation_limit":..,"starved":..,"longest_wait":..,"longest_queued":..} (-a/-W only)}
+        {"kind":"I","enabled":false} or the counters of the I report
+*/
+inline void Reporter::printJSON(const Snapshot &snap)
+{
+    out << "{\"kind\":\"" << snap.kind << '"';
+    if (snap.kind == 'I')
+    {
+        out << ",\"enabled\":" << (snap.statsEnabled ? "true" : "false");
+        if (snap.statsEnabled)
+        {
+            const Stats &stats = snap.stats;
+            double ns = stats.nanosPerTick();
+            out << ",\"commands\":{";
+            bool first = true;
+            for (int i = 0; i < (int)sizeof(STATS_COMMANDS); i++)
+            {
+                const StatCounter &c = stats.command[i];
+                if (c.calls == 0)
+                {
+                    continue;
+                }
+                out << (first ? "\"" : ",\"");
+                first = false;
+                if (i < (int)sizeof(STATS_COMMANDS) - 1)
+                {
+                    out << STATS_COMMANDS[i];
+                }
+                else
+                {
+                    out << "other";
+                }
+                out << "\":{\"count\":" << c.calls << ",\"avg_ns\":" << (long long)(c.timed ? c.ticks * ns / c.timed : 0)
+                    << ",\"p50_ns\":" << (long long)(stats.latency[i].percentile(0.50) * ns)
+                    << ",\"p99_ns\":" << (long long)(stats.latency[i].percentile(0.99) * ns) << '}';
+            }
+            const char *names[] = {"digestInput", "Q", "swap", "Dequeue", "Enqueue"};
+            const unsigned long long *calls[] = {&stats.digestInput, &stats.Q, &stats.swap, &stats.dequeue, &stats.enqueue};
+            out << "},\"hot_path\":{";
+            for (int i = 0; i < 5; i++)
+            {
+                out << (i ? ",\"" : "\"") << names[i] << "\":{\"calls\":" << *calls[i] << '}';
+            }
+            out << "},\"context_switches\":" << stats.contextSwitches << ",\"depth_high_water\":[";
+            for (int level = 0; level < STATS_LEVELS; level++)
+            {
+                out << (level ? "," : "") << stats.depthHighWater[level];
+            }
+            out << ']';
+        }
+        out << "}\n";
+        return;
+    }
+    out << ",\"time\":" << snap.Time;
+    if (snap.kind == 'T')
+    {
+        out << ",\"completed\":" << (long long)snap.processesCompleted
+            << ",\"turnaround_sum\":" << (long long)snap.turnaroundTimeSum
+            << ",\"average_turnaround\":" << (snap.processesCompleted ? snap.turnaroundTimeSum / snap.processesCompleted : 0);
+        jsonDistribution("turnaround", snap.turnaroundTimes);
+        jsonDistribution("waiting", snap.waitingTimes);
+        jsonDistribution("response", snap.responseTimes);
+        out << ",\"cores\":[";
+        for (int c = 0; c < (int)snap.coreStats.size(); c++)
+        {
+            const CoreRow &core = snap.coreStats[c];
+            out << (c ? "," : "") << "{\"utilization\":" << (snap.Time ? 100 * core.busyTime / snap.Time : 0)
+                << ",\"completed\":" << (long long)core.processesCompleted
+                << ",\"average_turnaround\":" << (core.processesCompleted ? core.turnaroundTimeSum / core.processesCompleted : 0)
+                << ",\"steals\":" << (long long)core.steals << '}';
+        }
+        out << ']';
+        if (snap.ticks.period > 0)
+        {
+            out << ",\"ticks\":{\"period_us\":" << snap.ticks.period << ",\"quanta\":" << snap.ticks.quanta
+                << ",\"missed\":" << snap.ticks.missed;
+            jsonDistribution("late_us", snap.ticks.lateness);
+            out << '}';
+        }
+        if (snap.aging.starvationLimit > 0)
+        {
+            out << ",\"aging\":{\"interval\":" << snap.aging.interval << ",\"promotions\":" << snap.aging.promotions
+                << ",\"starvation_limit\":" << snap.aging.starvationLimit << ",\"starved\":" << snap.aging.starved
+                << ",\"longest_wait\":" << snap.aging.longestWait << ",\"longest_queued\":" << snap.aging.longestQueued << '}';
+        }
+        if (snap.jobs.launched > 0)
+        {
+            out << ",\"jobs\":{\"launched\":" << snap.jobs.launched << ",\"cpu_ms\":" << snap.jobs.cpuMillis
+                << ",\"switches\":" << snap.jobs.switches;
+            jsonDistribution("switch_ns", snap.jobs.switchCost);
+            out << '}';
+        }
+        out << "}\n";
+        return;
+    }
+
+    const PCBRow *row = snap.rows.data();
+    int group = 0;
+    out << ",\"columns\":[\"pid\",\"priority\",\"value\",\"start\",\"cpu\"],\"running\":";
+    jsonRows(snap.running.data(), snap.cores);
+    out << ",\"blocked\":[";
+    for (int i = 0; i < snap.resources; i++)
+    {
+        int rsize = snap.counts[group++];
+        out << (i ? "," : "") << "{\"resource\":" << snap.resourceIds[i] << ",\"processes\":";
+        jsonRows(row, rsize);
+        row += rsize;
+        out << '}';
+    }
+    out << "],\"ready\":[";
+    for (int c = 0; c < snap.cores; c++)
+    {
+        out << (c ? ",[" : "[");
+        for (int i = 0; i < snap.levels; i++)
+        {
+            int size = snap.counts[group++];
+            if (i)
+            {
+                out << ',';
+            }
+            jsonRows(row, size);
+            row += size;
+        }
+        out << ']';
+    }
+    out << "]}\n";
+}
+
+inline void Reporter::jsonRows(const PCBRow *rows, int count)
+{
+    out << '[';
+    for (int k = 0; k < count; k++)
+    {
+        const PCBRow &row = rows[k];
+        out << (k ? ",[" : "[") << row.pid << ',' << row.priority << ',' << row.value << ',' << row.start_time << ',' << row.cpu_time << ']';
+    }
+    out << ']';
+}
+
+inline void Reporter::jsonDistribution(const char *name, const LatencyHistogram &times)
+{
+    out << ",\"" << name << "\":{\"p50\":" << times.percentile(0.50) << ",\"p90\":" << times.percentile(0.90)
+        << ",\"p99\":" << times.percentile(0.99) << ",\"max\":" << times.max() << '}';
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef RESOURCE_TABLE_H
+#define RESOURCE_TABLE_H
+/*
+    Blocked processes of any number of resources.
+    A resource exists only while processes wait on it: it is created by the first block and released when
+    its last waiter is unblocked, so memory follows the number of waiters, not the range of resource IDs.
+    Each resource keeps one FIFO per priority level as intrusive lists through a shared node pool, plus a
+    bitmap of its non-empty levels, so block and unblock are O(1) (one hash lookup, one count-trailing-zeros).
+    The lists are doubly linked and block returns the waiter's node, so one waiter can also be removed in
+    O(1) (a block timing out). The IDs of the resources that have waiters are kept in a list for reporting.
+*/
+//====| STL Includes |====//
+#include <vector>
+#include <unordered_map>
+
+//====| Local Includes |====//
+#include "image.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define RT_NONE -1 // End of a list / no record
+
+//====| Class Declaration |====//
+class ResourceTable
+{
+private:
+    struct Resource
+    {
+        int rid;
+        int waiters;
+        unsigned long long nonEmpty; // Bit l is set while level l has waiters
+        int activeIndex;             // Position of rid in active
+    };
+
+    int levels;
+    vector<Resource> records;         // Resources with waiters; freed records are reused
+    vector<int> heads;                // heads[record * levels + level]: first node of that FIFO
+    vector<int> tails;                // tails[record * levels + level]: last node of that FIFO
+    vector<int> freeRecords;
+    unordered_map<int, int> index;    // rid -> record
+    vector<int> active;               // rids with waiters, in no particular order
+    vector<int> nodePid;              // Node pool: the waiting PID,
+    vector<int> nodeNext;             //            the next node of its FIFO (or of the free list),
+    vector<int> nodePrev;             //            the previous node of its FIFO
+    vector<int> nodeList;             //            and its FIFO (record * levels + level)
+    int freeNode;
+
+    int find(int rid) const;
+    int acquireRecord(int rid);
+    void releaseRecord(int record);
+
+public:
+    //----| Constructor(s) |----//
+    ResourceTable(int lvls) : levels(lvls), freeNode(RT_NONE) {}
+
+    //----| Setters |----//
+    int block(int rid, int pid, int level); // Queues pid at the back of level on resource rid; returns its node
+    int unblock(int rid);                   // Removes the first waiter of the highest-priority level; 0 if none
+    void remove(int node);                  // Removes one waiter, wherever it is in its FIFO
+
+    //----| Getters |----//
+    int waiting(int rid) const;                           // Number of processes waiting on rid
+    int front(int rid) const;                             // Node unblock would remove; RT_NONE if none
+    int pidOf(int node) const { return nodePid[node]; }
+    int ridOf(int node) const { return records[nodeList[node] / levels].rid; }
+    const vector<int> &withWaiters() const { return active; } // rids with at least one waiter, unordered
+
+    //----| Checkpoint |----//
+    void save(ImageWriter &) const;
+    bool load(ImageReader &);
+
+    /*
+        Calls f(pid) for every process waiting on rid, in the order they would be unblocked.
+    */
+    template <class F>
+    void forEachWaiter(int rid, F f) const
+    {
+        int record = find(rid);
+        if (record == RT_NONE)
+        {
+            return;
+        }
+        for (int level = 0; level < levels; level++)
+        {
+            for (int node = heads[record * levels + level]; node != RT_NONE; node = nodeNext[node])
+            {
+                f(nodePid[node]);
+            }
+        }
+    }
+};
+
+//====| Class Definitions |====//
+
+//----| Setters |----//
+
+inline int ResourceTable::block(int rid, int pid, int level)
+{
+    int record = find(rid);
+    if (record == RT_NONE)
+    {
+        record = acquireRecord(rid);
+    }
+    int node = freeNode;
+    if (node == RT_NONE)
+    {
+        node = nodePid.size();
+        nodePid.push_back(0);
+        nodeNext.push_back(RT_NONE);
+        nodePrev.push_back(RT_NONE);
+        nodeList.push_back(RT_NONE);
+    }
+    else
+    {
+        freeNode = nodeNext[node];
+    }
+    int list = record * levels + level;
+    nodePid[node] = pid;
+    nodeNext[node] = RT_NONE;
+    nodePrev[node] = tails[list];
+    nodeList[node] = list;
+    if (tails[list] == RT_NONE)
+    {
+        heads[list] = node;
+    }
+    else
+    {
+        nodeNext[tails[list]] = node;
+    }
+    tails[list] = node;
+    records[record].nonEmpty |= 1ULL << level;
+    records[record].waiters++;
+    return node;
+}
+
+inline int ResourceTable::unblock(int rid)
+{
+    int node = front(rid);
+    if (node == RT_NONE)
+    {
+        return 0;
+    }
+    int pid = nodePid[node];
+    remove(node);
+    return pid;
+}
+
+/*
+    Unlinks node from its FIFO and returns it to the pool; the resource is released with its last waiter.
+*/
+inline void ResourceTable::remove(int node)
+{
+    int list = nodeList[node];
+    int record = list / levels;
+    Resource &resource = records[record];
+    if (nodePrev[node] == RT_NONE)
+    {
+        heads[list] = nodeNext[node];
+    }
+    else
+    {
+        nodeNext[nodePrev[node]] = nodeNext[node];
+    }
+    if (nodeNext[node] == RT_NONE)
+    {
+        tails[list] = nodePrev[node];
+    }
+    else
+    {
+        nodePrev[nodeNext[node]] = nodePrev[node];
+    }
+    if (heads[list] == RT_NONE)
+    {
+        resource.nonEmpty &= ~(1ULL << (list % levels));
+    }
+    nodeNext[node] = freeNode;
+    freeNode = node;
+    if (--resource.waiters == 0)
+    {
+        releaseRecord(record);
+    }
+}
+
+//----| Getters |----//
+
+inline int ResourceTable::front(int rid) const
+{
+    int record = find(rid);
+    if (record == RT_NONE)
+    {
+        return RT_NONE;
+    }
+    return heads[record * levels + __builtin_ctzll(records[record].nonEmpty)];
+}
+
+inline int ResourceTable::waiting(int rid) const
+{
+    int record = find(rid);
+    return record == RT_NONE ? 0 : records[record].waiters;
+}
+
+//----| Checkpoint |----//
+
+inline void ResourceTable::save(ImageWriter &out) const
+{
+    out.value(levels);
+    out.array(records);
+    out.array(heads);
+    out.array(tails);
+    out.array(freeRecords);
+    out.array(active);
+    out.array(nodePid);
+    out.array(nodeNext);
+    out.array(nodePrev);
+    out.array(nodeList);
+    out.value(freeNode);
+}
+
+/*
+    The rid index is not saved; it is rebuilt from the records that have waiters.
+*/
+inline bool ResourceTable::load(ImageReader &in)
+{
+    int saved = 0;
+    in.value(saved);
+    if (saved != levels)
+    {
+        return false;
+    }
+    in.array(records);
+    in.array(heads);
+    in.array(tails);
+    in.array(freeRecords);
+    in.array(active);
+    in.array(nodePid);
+    in.array(nodeNext);
+    in.array(nodePrev);
+    in.array(nodeList);
+    in.value(freeNode);
+    index.clear();
+    for (size_t record = 0; record < records.size(); record++)
+    {
+        if (records[record].waiters > 0)
+        {
+            index[records[record].rid] = record;
+        }
+    }
+    return in.good() && heads.size() == records.size() * levels && tails.size() == heads.size() &&
+           nodeNext.size() == nodePid.size() && nodePrev.size() == nodePid.size() && nodeList.size() == nodePid.size();
+}
+
+//----| Helpers |----//
+
+inline int ResourceTable::find(int rid) const
+{
+    unordered_map<int, int>::const_iterator it = index.find(rid);
+    return it == index.end() ? RT_NONE : it->second;
+}
+
+/*
+    Takes a free record (or a new one) for rid, with every level empty, and lists rid as active.
+*/
+inline int ResourceTable::acquireRecord(int rid)
+{
+    int record;
+    if (freeRecords.empty())
+    {
+        record = records.size();
+        records.push_back(Resource());
+        heads.resize(heads.size() + levels, RT_NONE);
+        tails.resize(tails.size() + levels, RT_NONE);
+    }
+    else
+    {
+        record = freeRecords.back();
+        freeRecords.pop_back();
+    }
+    records[record] = Resource{rid, 0, 0, (int)active.size()};
+    active.push_back(rid);
+    index[rid] = record;
+    return record;
+}
+
+/*
+    Called once the last waiter has left: every level is already empty.
+*/
+inline void ResourceTable::releaseRecord(int record)
+{
+    Resource &resource = records[record];
+    int last = active.back();
+    active[resource.activeIndex] = last;
+    records[index[last]].activeIndex = resource.activeIndex;
+    active.pop_back();
+    index.erase(resource.rid);
+    freeRecords.push_back(record);
+}
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef SCHEDULING_POLICY_H
+#define SCHEDULING_POLICY_H
+/*
+    Scheduling policies for Process_Manager<Policy>.
+    A policy decides the quantum of each priority level, how a process's priority changes when it starts,
+    uses up its quantum or blocks, and which ready process a core runs next. Everything is resolved at
+    compile time: the quantum is a constexpr table lookup and the hooks are inlined, so a policy that
+    does nothing in a hook costs nothing.
+    The policy is chosen per build with -DPM_POLICY=<name> (see the makefile targets); MLFQPolicy by default.
+    The CFS engine, which replaces the level queues with a VruntimeHeap, is also compiled into every build
+    and chosen at startup (processManager -e cfs).
+
+    Interface:
+        ReadyQueue      type of a core's ready queue (QueueArray<int> for the level-based policies)
+        levels          number of priority levels (ready queues per core)
+        quantum[level]  ticks a process at that level runs before it is preempted
+        ages            whether processManager -a aging applies: a queued process counts as one level higher
+                        for every interval it has waited (only where levels are priorities)
+        enqueue(r, pcb) queues a process that became ready
+        started(pcb)    a process was created (by S)
+        expired(pcb)    the running process used up its quantum
+        blocked(pcb)    the running process blocked on a resource
+        charge(l, t)    a process at level l ran for t ticks
+        select(ready)   dequeues the process a core runs next; 0 if ready is empty
+*/
+//====| Local Includes |====//
+#include "queue_array.h"
+#include "pcb_store.h"
+#include "vruntime_heap.h"
+
+//====| Policies |====//
+
+/*
+    Ready queue shared by the level-based policies: one FIFO per priority level.
+*/
+struct LevelQueues
+{
+    typedef QueueArray<int> ReadyQueue;
+
+    void enqueue(ReadyQueue &ready, PCBRef pcb) { ready.Enqueue(pcb.getPID(), pcb.getPriority()); }
+};
+
+/*
+    Multilevel feedback queue (the original scheduler): a process that uses up its quantum drops a level
+    and gets twice the quantum, a process that blocks rises a level, and the highest non-empty level runs first.
+*/
+struct MLFQPolicy : LevelQueues
+{
+    static constexpr const char *name = "mlfq";
+    static constexpr int levels = 4;
+    static constexpr bool ages = true;
+    static constexpr int quantum[levels] = {1, 2, 4, 8};
+
+    void started(PCBRef) {}
+    void expired(PCBRef pcb) { pcb.incrementPriority(); }
+    void blocked(PCBRef pcb) { pcb.decrementPriority(); }
+    void charge(int, int) {}
+    int select(QueueArray<int> &ready) { return ready.Dequeue(); }
+};
+
+/*
+    Round robin: one level, a fixed quantum, first come first served.
+*/
+struct RoundRobinPolicy : LevelQueues
+{
+    static constexpr const char *name = "rr";
+    static constexpr int levels = 4;
+    static constexpr bool ages = false;
+    static constexpr int quantum[levels] = {4, 4, 4, 4};
+
+    void started(PCBRef) {}
+    void expired(PCBRef) {}
+    void blocked(PCBRef) {}
+    void charge(int, int) {}
+    int select(QueueArray<int> &ready) { return ready.Dequeue(); }
+};
+
+/*
+    Static priority: the level is fixed when the process starts, from its run time (the level whose
+    quantum first covers it, so short jobs go first), and the highest non-empty level runs first.
+*/
+struct PriorityPolicy : LevelQueues
+{
+    static constexpr const char *name = "priority";
+    static constexpr int levels = 4;
+    static constexpr bool ages = true;
+    static constexpr int quantum[levels] = {1, 2, 4, 8};
+
+    void started(PCBRef pcb)
+    {
+        int level = 0;
+        while (level < levels - 1 && pcb.getRun() > quantum[level])
+        {
+            level++;
+        }
+        pcb.setPriority(level);
+    }
+    void expired(PCBRef) {}
+    void blocked(PCBRef) {}
+    void charge(int, int) {}
+    int select(QueueArray<int> &ready) { return ready.Dequeue(); }
+};
+
+/*
+    Lottery: levels change as in MLFQ, but the next process is drawn at random, each queued process holding
+    the tickets of its level. Higher levels win more often; no level can starve another.
+*/
+struct LotteryPolicy : LevelQueues
+{
+    static constexpr const char *name = "lottery";
+    static constexpr int levels = 4;
+    static constexpr bool ages = false;
+    static constexpr int quantum[levels] = {1, 2, 4, 8};
+    static constexpr int tickets[levels] = {8, 4, 2, 1};
+    unsigned long long seed = 0x9E3779B97F4A7C15ULL; // xorshift64 state; fixed so runs are reproducible
+
+    void started(PCBRef) {}
+    void expired(PCBRef pcb) { pcb.incrementPriority(); }
+    void blocked(PCBRef pcb) { pcb.decrementPriority(); }
+    void charge(int, int) {}
+    int select(QueueArray<int> &ready)
+    {
+        long long total = 0;
+        for (int level = 0; level < levels; level++)
+        {
+            total += (long long)ready.Qsize(level) * tickets[level];
+        }
+        if (total == 0)
+        {
+            return 0;
+        }
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        long long draw = seed % total;
+        int level = 0;
+        while (draw >= (long long)ready.Qsize(level) * tickets[level])
+        {
+            draw -= (long long)ready.Qsize(level) * tickets[level];
+            level++;
+        }
+        return ready.Dequeue(level);
+    }
+};
+
+/*
+    Fair share: each level is a group (a process joins group pid mod levels when it starts), and the next
+    process comes from the waiting group that has had the least CPU time so far.
+*/
+struct FairSharePolicy : LevelQueues
+{
+    static constexpr const char *name = "fairshare";
+    static constexpr int levels = 4;
+    static constexpr bool ages = false;
+    static constexpr int quantum[levels] = {2, 2, 2, 2};
+    long long usage[levels] = {0, 0, 0, 0}; // CPU ticks used by each group
+
+    void started(PCBRef pcb) { pcb.setPriority(((pcb.getPID() % levels) + levels) % levels); }
+    void expired(PCBRef) {}
+    void blocked(PCBRef) {}
+    void charge(int level, int ticks) { usage[level] += ticks; }
+    int select(QueueArray<int> &ready)
+    {
+        int best = -1;
+        for (int level = 0; level < levels; level++)
+        {
+            if (ready.Qsize(level) > 0 && (best < 0 || usage[level] < usage[best]))
+            {
+                best = level;
+            }
+        }
+        return best < 0 ? 0 : ready.Dequeue(best);
+    }
+};
+
+/*
+    Completely fair scheduling: no levels (every process stays at priority 0); the ready process with the
+    least virtual runtime, here its cpu_time, runs next for a fixed slice. Kept in a VruntimeHeap, so it
+    stays O(log n) and fair with thousands of runnable processes. Chosen at startup with processManager -e cfs.
+*/
+struct CFSPolicy
+{
+    typedef VruntimeHeap ReadyQueue;
+    static constexpr const char *name = "cfs";
+    static constexpr int levels = 4;
+    static constexpr bool ages = false;
+    static constexpr int quantum[levels] = {3, 3, 3, 3};
+
+    void enqueue(ReadyQueue &ready, PCBRef pcb) { ready.push(pcb.getPID(), pcb.getCPU()); }
+    void started(PCBRef) {}
+    void expired(PCBRef) {}
+    void blocked(PCBRef) {}
+    void charge(int, int) {}
+    int select(ReadyQueue &ready) { return ready.pop(); }
+};
+
+#ifndef PM_POLICY
+#define PM_POLICY MLFQPolicy
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+/*
+    Shared-memory command transport between commander and processManager (commander -m).
+    commander creates a memfd holding one ShmRing, maps it and hands the descriptor to processManager, which
+    maps the same pages. Commands then go through a single-producer / single-consumer ring of Command records
+    in that memory: a push or pop is one 16-byte copy and one release store of tail or head, with no system call.
+    A side that finds the ring empty (consumer) or full (producer) polls for a moment on machines with more
+    than one CPU, then sleeps on a futex on the other side's index. The other side only makes the FUTEX_WAKE
+    call while the matching sleeping flag is set, and then only once SHM_WAKE_BATCH commands (or free cells)
+    are waiting, on flush() or on close(), so like the pipe's batched writes a sleeper is woken once per
+    batch rather than once per command. A consumer that is still polling sees each command at once.
+    A partial batch is only delivered to a sleeping consumer by flush(), so the producer must call it
+    before it blocks on anything else (commander does whenever its standard input runs dry); otherwise
+    commands already in the ring can wait indefinitely.
+*/
+//====| STL Includes |====//
+#include <atomic>
+#include <new>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+//====| Local Includes |====//
+#include "command.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define SHM_RING_SIZE 4096 // Commands in the ring (a power of two)
+#define SHM_SPIN 4000      // Polls of an empty/full ring before sleeping (when there is another CPU to fill/drain it)
+#define SHM_WAKE_BATCH (SHM_RING_SIZE / 4) // Commands (free cells) that make a sleeping consumer (producer) worth waking
+
+//====| Futex |====//
+
+/*
+    Sleeps while *word still holds expected (or until a signal). The mapping is shared, so no FUTEX_PRIVATE_FLAG.
+*/
+inline void futexWait(atomic<uint32_t> *word, uint32_t expected)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+inline void futexWake(atomic<uint32_t> *word)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/*
+    Polls to make before sleeping: spinning only helps if the other side can run at the same time.
+*/
+inline int spinLimit()
+{
+    static const int limit = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_SPIN : 0;
+    return limit;
+}
+
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+//====| Class Declaration |====//
+struct ShmRing
+{
+    alignas(64) atomic<uint32_t> tail;   // Next cell the producer fills (futex word the consumer sleeps on)
+    atomic<uint32_t> consumerSleeping;
+    alignas(64) atomic<uint32_t> head;   // Next cell the consumer reads (futex word the producer sleeps on)
+    atomic<uint32_t> producerSleeping;
+    alignas(64) atomic<uint32_t> closed; // No more commands will be pushed
+    alignas(64) Command cells[SHM_RING_SIZE];
+
+    //----| Setup |----//
+    static ShmRing *create(int &fd); // New ring in a memfd a child process inherits; NULL on failure
+    static ShmRing *map(int fd);     // The ring of an inherited memfd; NULL on failure
+
+    //----| Producer |----//
+    bool push(const Command &cmd); // Waits while full; false once the ring is closed
+    bool flush();                  // Wakes the consumer if it sleeps with commands waiting; call before waiting for input
+    void close();                  // Ends the stream; also safe from a signal handler
+
+    //----| Consumer |----//
+    void pop(Command &cmd); // Waits while empty; cmd.op is END_OF_STREAM once closed and drained
+};
+
+//====| Class Definitions |====//
+
+inline ShmRing *ShmRing::create(int &fd)
+{
+    fd = memfd_create("processManager.commands", 0); // Not close-on-exec: processManager inherits it
+    if (fd < 0 || ftruncate(fd, sizeof(ShmRing)))
+    {
+        perror("unable to create the shared command ring");
+        return NULL;
+    }
+    void *memory = mmap(NULL, sizeof(ShmRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        perror("unable to map the shared command ring");
+        return NULL;
+    }
+    return new (memory) ShmRing(); // The memfd starts zeroed; this just makes the atomics official
+}
+
+inline ShmRing *ShmRing::map(int fd)
+{
+    void *memory = mmap(NULL, sizeof(ShmRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        perror("unable to map the shared command ring");
+        return NULL;
+    }
+    return (ShmRing *)memory;
+}
+
+/*
+    Waking is a hint on the fast path: after a push (pop) the other side's sleeping flag is read without a
+    fence, so a sleeper that went to bed just then may be missed until the next push (pop), flush() or close(),
+    which is the same delay a partial batch already gets. What makes it safe is the sleep path: a side sets its
+    own flag, issues a full fence, wakes the other side if that one is flagged, and only then takes its last
+    look at the other index, so both sides can never be asleep at once. The waker clears the flag, so one
+    sleep costs one FUTEX_WAKE even if the sleeper has not run again yet.
+*/
+inline bool ShmRing::push(const Command &cmd)
+{
+    uint32_t t = tail.load(memory_order_relaxed);
+    int spins = spinLimit();
+    while (t - head.load(memory_order_acquire) == SHM_RING_SIZE)
+    {
+        if (closed.load(memory_order_acquire))
+        {
+            return false;
+        }
+        if (spins-- > 0)
+        {
+            cpuRelax();
+            continue;
+        }
+        producerSleeping.store(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (consumerSleeping.exchange(0, memory_order_relaxed))
+        {
+            futexWake(&tail);
+        }
+        uint32_t h = head.load(memory_order_relaxed);
+        if (t - h == SHM_RING_SIZE && !closed.load(memory_order_relaxed))
+        {
+            futexWait(&head, h);
+        }
+        producerSleeping.store(0, memory_order_relaxed);
+    }
+    if (closed.load(memory_order_relaxed))
+    {
+        return false;
+    }
+    cells[t & (SHM_RING_SIZE - 1)] = cmd;
+    tail.store(t + 1, memory_order_release);
+    if (consumerSleeping.load(memory_order_relaxed) && t + 1 - head.load(memory_order_relaxed) >= SHM_WAKE_BATCH &&
+        consumerSleeping.exchange(0, memory_order_relaxed))
+    {
+        futexWake(&tail);
+    }
+    return true;
+}
+
+inline bool ShmRing::flush()
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (consumerSleeping.load(memory_order_relaxed) && consumerSleeping.exchange(0, memory_order_relaxed))
+    {
+        futexWake(&tail);
+    }
+    return closed.load(memory_order_relaxed) == 0;
+}
+
+inline void ShmRing::close()
+{
+    closed.store(1, memory_order_seq_cst);
+    futexWake(&tail);
+    futexWake(&head);
+}
+
+inline void ShmRing::pop(Command &cmd)
+{
+    uint32_t h = head.load(memory_order_relaxed);
+    int spins = spinLimit();
+    while (tail.load(memory_order_acquire) == h)
+    {
+        if (closed.load(memory_order_acquire) && tail.load(memory_order_acquire) == h)
+        {
+            cmd.op = END_OF_STREAM;
+            return;
+        }
+        if (spins-- > 0)
+        {
+            cpuRelax();
+            continue;
+        }
+        consumerSleeping.store(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (producerSleeping.exchange(0, memory_order_relaxed))
+        {
+            futexWake(&head);
+        }
+        if (tail.load(memory_order_relaxed) == h && !closed.load(memory_order_relaxed))
+        {
+            futexWait(&tail, h);
+        }
+        consumerSleeping.store(0, memory_order_relaxed);
+    }
+    cmd = cells[h & (SHM_RING_SIZE - 1)];
+    head.store(h + 1, memory_order_release);
+    if (producerSleeping.load(memory_order_relaxed) && SHM_RING_SIZE - (tail.load(memory_order_relaxed) - (h + 1)) >= SHM_WAKE_BATCH &&
+        producerSleeping.exchange(0, memory_order_relaxed))
+    {
+        futexWake(&head);
+    }
+}
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef STATS_H
+#define STATS_H
+/*
+    Hot-path instrumentation, compiled in only with -DPM_STATS (make STATS=-DPM_STATS).
+    Without it every STATS(...) hook expands to nothing. With it commands are timed in digestCommand only,
+    by one pair of time-stamp counter reads around the whole command, and only every STATS_SAMPLE-th command
+    of each kind (the first one always): per-command counts are exact, time and latency histograms come from
+    the sample. The hot paths inside a command (digestInput, Q, swap, QueueArray Dequeue/Enqueue) only count
+    their calls, and context switches and the deepest each queue level has been are plain counters.
+    A counter read costs tens of nanoseconds on some (virtualized) machines, so timing every command would
+    cost more than the command; make STATS="-DPM_STATS -DSTATS_SAMPLE=1" does it anyway.
+    The I command prints them.
+*/
+//====| STL Includes |====//
+#include <chrono>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//====| Globals Variables |====//
+#define STATS_BUCKETS 40 // Latency histogram buckets: bucket b counts latencies in [2^(b-1), 2^b) ticks
+#define STATS_LEVELS 64  // Queue levels whose depth high-water mark is tracked
+#define STATS_COMMANDS "SBUQCPTIK"
+#ifndef STATS_SAMPLE
+#define STATS_SAMPLE 16  // Every STATS_SAMPLE-th command of each kind is timed
+#endif
+
+#ifdef PM_STATS
+#define STATS(...) __VA_ARGS__
+#else
+#define STATS(...)
+#endif
+
+//====| Counters |====//
+
+/*
+    STATS_COMMANDS position of every byte, built at compile time.
+*/
+struct CommandTable
+{
+    unsigned char index[256];
+
+    constexpr CommandTable() : index()
+    {
+        for (int c = 0; c < 256; c++)
+        {
+            index[c] = sizeof(STATS_COMMANDS) - 1;
+        }
+        for (int i = 0; STATS_COMMANDS[i] != 0; i++)
+        {
+            index[(unsigned char)STATS_COMMANDS[i]] = i;
+        }
+    }
+};
+
+/*
+    Time-stamp counter (or the monotonic clock in nanoseconds where there is none).
+*/
+inline unsigned long long statTicks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct StatCounter
+{
+    unsigned long long calls;
+    unsigned long long timed; // Calls whose time is in ticks
+    unsigned long long ticks;
+};
+
+struct StatHistogram
+{
+    unsigned long long buckets[STATS_BUCKETS];
+
+    void add(unsigned long long ticks)
+    {
+        int b = ticks ? 64 - __builtin_clzll(ticks) : 0;
+        buckets[b < STATS_BUCKETS ? b : STATS_BUCKETS - 1]++;
+    }
+
+    /*
+        Upper bound (in ticks) of the bucket holding the p-th percentile; 0 if empty.
+    */
+    unsigned long long percentile(double p) const
+    {
+        unsigned long long total = 0, seen = 0;
+        for (int b = 0; b < STATS_BUCKETS; b++)
+        {
+            total += buckets[b];
+        }
+        for (int b = 0; b < STATS_BUCKETS; b++)
+        {
+            seen += buckets[b];
+            if (total && seen >= p * total)
+            {
+                return 1ULL << b;
+            }
+        }
+        return 0;
+    }
+};
+
+/*
+    Everything the I command reports. Plain data, so a Snapshot can copy it as a whole.
+*/
+struct Stats
+{
+    StatCounter command[sizeof(STATS_COMMANDS)]; // One per letter of STATS_COMMANDS, the last for anything else
+    StatHistogram latency[sizeof(STATS_COMMANDS)];
+    unsigned long long digestInput; // Calls; the time is in the command's own counter
+    unsigned long long Q;
+    unsigned long long swap;
+    unsigned long long dequeue;
+    unsigned long long enqueue;
+    unsigned long long contextSwitches;
+    int depthHighWater[STATS_LEVELS];
+    unsigned long long startTicks; // For converting ticks to nanoseconds
+    long long startNanos;
+
+    Stats()
+    {
+        memset(this, 0, sizeof(*this));
+        startTicks = statTicks();
+        startNanos = nowNanos();
+    }
+
+    static long long nowNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /*
+        Index of op in STATS_COMMANDS (the last one for anything else), by table lookup.
+    */
+    static int commandIndex(char op)
+    {
+        static constexpr CommandTable table{};
+        return table.index[(unsigned char)op];
+    }
+
+    void depth(int level, int size)
+    {
+        if (level < STATS_LEVELS && size > depthHighWater[level])
+        {
+            depthHighWater[level] = size;
+        }
+    }
+
+    /*
+        Nanoseconds per tick, measured over the lifetime of the counters.
+    */
+    double nanosPerTick() const
+    {
+        unsigned long long ticks = statTicks() - startTicks;
+        return ticks ? (double)(nowNanos() - startNanos) / ticks : 1;
+    }
+};
+
+/*
+    Counts one call, and for every STATS_SAMPLE-th call adds the time from construction to destruction to the
+    counter and optionally to a histogram. Only digestCommand uses one, around a whole command.
+*/
+class StatTimer
+{
+private:
+    StatCounter &counter;
+    StatHistogram *histogram;
+    bool timed;
+    unsigned long long start;
+
+public:
+    StatTimer(StatCounter &c, StatHistogram *h = NULL)
+        : counter(c), histogram(h), timed(c.calls % STATS_SAMPLE == 0), start(timed ? statTicks() : 0) {}
+    ~StatTimer()
+    {
+        counter.calls++;
+        if (!timed)
+        {
+            return;
+        }
+        unsigned long long ticks = statTicks() - start;
+        counter.ticks += ticks;
+        counter.timed++;
+        if (histogram != NULL)
+        {
+            histogram->add(ticks);
+        }
+    }
+};
+
+#ifdef PM_STATS
+inline Stats pmStats; // Counters of this process
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+/*
+    Wall-clock quanta for real-time mode (processManager -t period_us).
+    A TickClock is a timerfd on CLOCK_MONOTONIC that expires once per period. It sits in the producers'
+    epoll loop next to the command connections: when it fires, the loop reads the number of expirations and
+    pushes one TICK record onto the same ring as the S/B/U/P commands, so ticks and commands reach the
+    scheduler in one stream and neither waits on the other. The scheduler runs a tick as Q(expirations):
+    periods the loop or the scheduler fell behind on are caught up at once and counted as missed.
+    Tick jitter is how late the scheduler got to a tick, measured against that tick's ideal deadline.
+*/
+//====| STL Includes |====//
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+//====| Local Includes |====//
+#include "command.h"
+#include "latency_histogram.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Tick Statistics |====//
+/*
+    What T reports about real-time ticks (period 0: not in real-time mode).
+*/
+struct TickStats
+{
+    long long period = 0;          // Microseconds per quantum
+    unsigned long long quanta = 0; // Quanta the clock advanced by on ticks
+    unsigned long long missed = 0; // Of those, periods that expired while an earlier one was still unread
+    LatencyHistogram lateness;     // Microseconds from each tick's deadline to the scheduler running it
+};
+
+//====| Class Declaration |====//
+class TickClock
+{
+private:
+    int fd;
+    long long period;    // Nanoseconds
+    long long start;     // CLOCK_MONOTONIC nanoseconds of expiration 0; expiration n is due at start + n * period
+    long long sequence;  // Expirations read so far (event loop thread only)
+
+    static long long now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+public:
+    //----| Constructor(s) |----//
+    TickClock() : fd(-1), period(0), start(0), sequence(0) {}
+    ~TickClock()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+    TickClock(const TickClock &) = delete;
+    TickClock &operator=(const TickClock &) = delete;
+
+    /*
+        Starts expiring every periodMicros microseconds from now. Returns false if the timer cannot be made.
+    */
+    bool arm(long long periodMicros)
+    {
+        fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd < 0)
+        {
+            perror("unable to create the tick timer");
+            return false;
+        }
+        period = periodMicros * 1000;
+        start = now();
+        struct itimerspec spec;
+        spec.it_interval.tv_sec = period / 1000000000LL;
+        spec.it_interval.tv_nsec = period % 1000000000LL;
+        spec.it_value.tv_sec = (start + period) / 1000000000LL; // Absolute, so deadlines never drift from start
+        spec.it_value.tv_nsec = (start + period) % 1000000000LL;
+        if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL))
+        {
+            perror("unable to start the tick timer");
+            return false;
+        }
+        return true;
+    }
+
+    int descriptor() const { return fd; }
+
+    /*
+        Reads the expirations since the last call into a TICK record: arg[0] = how many, arg[1] = sequence
+        number of the last one. Returns false if the timer has not fired (a spurious wakeup).
+    */
+    bool expire(Command &tick)
+    {
+        uint64_t expirations;
+        if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations) || expirations == 0)
+        {
+            return false;
+        }
+        sequence += expirations;
+        memset(&tick, 0, sizeof(tick));
+        tick.op = TICK;
+        tick.arg[0] = expirations > INT32_MAX ? INT32_MAX : (int)expirations;
+        tick.arg[1] = (int)(sequence & INT32_MAX);
+        return true;
+    }
+
+    /*
+        Microseconds between the deadline of expiration seq (as carried by a TICK record) and now.
+    */
+    long long lateness(int seq) const
+    {
+        long long late = now() - (start + seq * period);
+        return late > 0 ? late / 1000 : 0;
+    }
+};
+
+#endif
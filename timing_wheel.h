@@ -0,0 +1,244 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+/*
+    Hierarchical timing wheel for block timeouts.
+    TW_LEVELS wheels of TW_SLOTS slots; a slot of level k spans 64^k ticks. A timer sits on the level of the
+    highest 6-bit digit in which its deadline differs from the current time, in the slot of that digit.
+    When the clock reaches the start of a slot its timers fire (level 0) or cascade to lower levels, so
+    every timer moves at most TW_LEVELS times. Timers are intrusive doubly-linked lists over arrays indexed
+    by the caller's ID, which makes schedule and cancel O(1). A per-level occupancy word turns finding the
+    next slot to visit into one count-trailing-zeros, so the clock can jump over empty stretches.
+*/
+//====| STL Includes |====//
+#include <vector>
+
+//====| Local Includes |====//
+#include "image.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define TW_BITS 6
+#define TW_SLOTS (1 << TW_BITS)
+#define TW_LEVELS 6 // 64^6 = 2^36 ticks ahead, more than an int Time can reach
+#define TW_NONE -1
+
+//====| Class Declaration |====//
+class TimingWheel
+{
+private:
+    long long now;
+    int head[TW_LEVELS][TW_SLOTS];
+    int tail[TW_LEVELS][TW_SLOTS];
+    unsigned long long occupied[TW_LEVELS]; // Bit s is set while slot s of the level has timers
+    vector<long long> deadline;             // Per timer ID
+    vector<int> next;
+    vector<int> prev;
+    vector<int> slotOf;                     // level * TW_SLOTS + slot, TW_NONE while the ID is not scheduled
+    int armed;                              // Timers scheduled
+
+    void link(int id);
+    void unlink(int id);
+
+public:
+    //----| Constructor(s) |----//
+    TimingWheel(long long start = 0);
+
+    //----| Setters |----//
+    void schedule(int id, long long when); // Fires id when the clock reaches when (> the current time)
+    void cancel(int id);                   // Does nothing if id is not scheduled
+
+    /*
+        Moves the clock to to, calling fire(id) for every timer due by then, in deadline order.
+    */
+    template <class F>
+    void advance(long long to, F fire)
+    {
+        long long when;
+        while ((when = nextEvent()) != TW_NONE && when <= to)
+        {
+            now = when;
+            int level = 0;
+            while (occupied[level] == 0)
+            {
+                level++;
+            }
+            int slot = __builtin_ctzll(occupied[level]);
+            int id = head[level][slot];
+            head[level][slot] = tail[level][slot] = TW_NONE;
+            occupied[level] &= occupied[level] - 1;
+            while (id != TW_NONE)
+            {
+                int following = next[id];
+                if (deadline[id] <= now)
+                {
+                    slotOf[id] = TW_NONE;
+                    armed--;
+                    fire(id);
+                }
+                else
+                {
+                    link(id); // Cascades to a lower level
+                }
+                id = following;
+            }
+        }
+        if (to > now)
+        {
+            now = to;
+        }
+    }
+
+    //----| Getters |----//
+    bool empty() const { return armed == 0; }
+    bool scheduled(int id) const { return id < (int)slotOf.size() && slotOf[id] != TW_NONE; }
+    long long nextEvent() const; // Start of the next non-empty slot (no timer is due before it); TW_NONE if empty
+
+    //----| Checkpoint |----//
+    void save(ImageWriter &) const;
+    bool load(ImageReader &);
+};
+
+//====| Class Definitions |====//
+
+inline TimingWheel::TimingWheel(long long start) : now(start), armed(0)
+{
+    for (int level = 0; level < TW_LEVELS; level++)
+    {
+        occupied[level] = 0;
+        for (int slot = 0; slot < TW_SLOTS; slot++)
+        {
+            head[level][slot] = tail[level][slot] = TW_NONE;
+        }
+    }
+}
+
+//----| Setters |----//
+
+inline void TimingWheel::schedule(int id, long long when)
+{
+    if (id >= (int)slotOf.size())
+    {
+        deadline.resize(id + 1);
+        next.resize(id + 1);
+        prev.resize(id + 1);
+        slotOf.resize(id + 1, TW_NONE);
+    }
+    cancel(id);
+    deadline[id] = when > now ? when : now + 1;
+    link(id);
+    armed++;
+}
+
+inline void TimingWheel::cancel(int id)
+{
+    if (scheduled(id))
+    {
+        unlink(id);
+        slotOf[id] = TW_NONE;
+        armed--;
+    }
+}
+
+//----| Getters |----//
+
+/*
+    Every timer of level k is in a slot past the current time's digit k, so the first occupied slot of the
+    lowest non-empty level is the next one the clock reaches.
+*/
+inline long long TimingWheel::nextEvent() const
+{
+    for (int level = 0; level < TW_LEVELS; level++)
+    {
+        if (occupied[level])
+        {
+            int shift = TW_BITS * level;
+            long long base = (now >> (shift + TW_BITS)) << (shift + TW_BITS);
+            return base | ((long long)__builtin_ctzll(occupied[level]) << shift);
+        }
+    }
+    return TW_NONE;
+}
+
+//----| Checkpoint |----//
+
+inline void TimingWheel::save(ImageWriter &out) const
+{
+    out.value(now);
+    out.value(head);
+    out.value(tail);
+    out.value(occupied);
+    out.array(deadline);
+    out.array(next);
+    out.array(prev);
+    out.array(slotOf);
+    out.value(armed);
+}
+
+inline bool TimingWheel::load(ImageReader &in)
+{
+    in.value(now);
+    in.value(head);
+    in.value(tail);
+    in.value(occupied);
+    in.array(deadline);
+    in.array(next);
+    in.array(prev);
+    in.array(slotOf);
+    in.value(armed);
+    return in.good() && next.size() == deadline.size() && prev.size() == deadline.size() && slotOf.size() == deadline.size();
+}
+
+//----| Helpers |----//
+
+/*
+    Appends id to the slot its deadline maps to from the current time.
+*/
+inline void TimingWheel::link(int id)
+{
+    unsigned long long differ = (unsigned long long)(deadline[id] ^ now);
+    int level = differ ? (63 - __builtin_clzll(differ)) / TW_BITS : 0;
+    int slot = (deadline[id] >> (TW_BITS * level)) & (TW_SLOTS - 1);
+    next[id] = TW_NONE;
+    prev[id] = tail[level][slot];
+    if (tail[level][slot] == TW_NONE)
+    {
+        head[level][slot] = id;
+    }
+    else
+    {
+        next[tail[level][slot]] = id;
+    }
+    tail[level][slot] = id;
+    occupied[level] |= 1ULL << slot;
+    slotOf[id] = level * TW_SLOTS + slot;
+}
+
+inline void TimingWheel::unlink(int id)
+{
+    int level = slotOf[id] / TW_SLOTS;
+    int slot = slotOf[id] % TW_SLOTS;
+    if (prev[id] == TW_NONE)
+    {
+        head[level][slot] = next[id];
+    }
+    else
+    {
+        next[prev[id]] = next[id];
+    }
+    if (next[id] == TW_NONE)
+    {
+        tail[level][slot] = prev[id];
+    }
+    else
+    {
+        prev[next[id]] = prev[id];
+    }
+    if (head[level][slot] == TW_NONE)
+    {
+        occupied[level] &= ~(1ULL << slot);
+    }
+}
+
+#endif
@@ -0,0 +1,320 @@
+/*
+    Description:
+        Offline viewer for the scheduling event traces processManager records with -j (see event_trace.h).
+        Prints a summary (events by kind, per-core utilization and per-PID CPU time and share) and optionally
+        every event in order (-d) or a Gantt chart of which PID each core ran (-g).
+        Usage: traceView [-d] [-g] [-w width] [-f from] [-t to] trace_file
+            -d  replay: print every event, one per line
+            -g  Gantt chart, width columns wide (-w, default 100), of the interval [from, to] (default: the whole trace)
+        e.g. ./commander -- -n 2 -j run.trace < prog2_input.txt > /dev/null; ./traceView -g run.trace
+*/
+
+//====| STL Includes |====//
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <unistd.h>
+
+//====| Local Includes |====//
+#include "event_trace.h"
+
+//====| Namespace |====//
+using namespace std;
+
+//====| Globals Variables |====//
+#define TRACE_READ 4096 // Events read per fread
+#define GANTT_SYMBOLS "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+
+//====| Summary |====//
+
+/*
+    A stretch of time one core spent on one PID (pid < 1: idle).
+*/
+struct Slice
+{
+    long long from;
+    long long to;
+    int pid;
+};
+
+struct ProcessSummary
+{
+    long long cpu = 0;
+    int dispatches = 0;
+    int preemptions = 0;
+    int blocks = 0;
+    long long start = -1;
+    long long finish = -1;
+};
+
+/*
+    Prints one event the way the P and T reports name things.
+*/
+void printEvent(const TraceEvent &e)
+{
+    cout << setw(10) << e.time << "  " << (char)e.kind << "  core " << setw(3) << e.core << "  pid " << setw(8) << e.pid
+         << "  level " << (int)e.level;
+    switch (e.kind)
+    {
+    case TRACE_START:
+        cout << "  start, run time " << e.arg;
+        break;
+    case TRACE_DISPATCH:
+        if (e.pid < 1)
+        {
+            cout << "  idle";
+        }
+        else
+        {
+            cout << "  dispatch, quantum " << e.arg;
+        }
+        break;
+    case TRACE_PREEMPT:
+        cout << "  quantum expired";
+        break;
+    case TRACE_EXIT:
+        cout << "  finished, turnaround " << e.arg;
+        break;
+    case TRACE_BLOCK:
+        cout << "  blocked on resource " << e.arg;
+        break;
+    case TRACE_UNBLOCK:
+        cout << "  unblocked from resource " << e.arg;
+        break;
+    case TRACE_TIMEOUT:
+        cout << "  timed out on resource " << e.arg;
+        break;
+    default:
+        cout << "  unknown event";
+    }
+    cout << endl;
+}
+
+/*
+    One row per core: each column shows the PID that ran at the middle of its time span ('.' idle, ' ' unknown).
+*/
+void printGantt(const vector<vector<Slice>> &slices, long long from, long long to, int width)
+{
+    if (to <= from)
+    {
+        cout << "nothing ran in [" << from << ", " << to << "]" << endl;
+        return;
+    }
+    double span = (double)(to - from) / width;
+    const string symbols = GANTT_SYMBOLS;
+    map<int, char> symbol; // PID -> its letter, in order of first appearance on the chart
+    cout << "Gantt chart of [" << from << ", " << to << "], " << span << " ticks per column" << endl;
+    for (size_t c = 0; c < slices.size(); c++)
+    {
+        string row(width, ' ');
+        size_t s = 0;
+        for (int col = 0; col < width; col++)
+        {
+            double t = from + (col + 0.5) * span;
+            while (s < slices[c].size() && slices[c][s].to <= t)
+            {
+                s++;
+            }
+            if (s == slices[c].size() || slices[c][s].from > t)
+            {
+                continue;
+            }
+            int pid = slices[c][s].pid;
+            if (pid < 1)
+            {
+                row[col] = '.';
+                continue;
+            }
+            if (symbol.find(pid) == symbol.end())
+            {
+                symbol[pid] = symbols[symbol.size() % symbols.size()];
+            }
+            row[col] = symbol[pid];
+        }
+        cout << "Core " << setw(3) << c << " |" << row << "|" << endl;
+    }
+    cout << "Legend:";
+    for (map<int, char>::iterator it = symbol.begin(); it != symbol.end(); ++it)
+    {
+        cout << " " << it->second << "=" << it->first;
+    }
+    cout << endl;
+}
+
+//====| Main Program |====//
+
+int main(int argc, char *argv[])
+{
+    bool dump = false;
+    bool gantt = false;
+    int width = 100;
+    long long from = -1;
+    long long to = -1;
+    int opt;
+    while ((opt = getopt(argc, argv, "dgw:f:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            dump = true;
+            break;
+        case 'g':
+            gantt = true;
+            break;
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'f':
+            from = atoll(optarg);
+            break;
+        case 't':
+            to = atoll(optarg);
+            break;
+        default:
+            cerr << "usage: " << argv[0] << " [-d] [-g] [-w width] [-f from] [-t to] trace_file" << endl;
+            return 1;
+        }
+    }
+    if (optind != argc - 1 || width < 1)
+    {
+        cerr << "usage: " << argv[0] << " [-d] [-g] [-w width] [-f from] [-t to] trace_file" << endl;
+        return 1;
+    }
+
+    FILE *file = fopen(argv[optind], "rb");
+    TraceHeader header;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1 || header.magic != TRACE_MAGIC ||
+        header.version != TRACE_VERSION || header.eventSize != (int)sizeof(TraceEvent) || header.cores < 1)
+    {
+        cerr << argv[optind] << " is not a version " << TRACE_VERSION << " scheduling trace" << endl;
+        return 1;
+    }
+    header.policy[sizeof(header.policy) - 1] = 0;
+
+    // Replay: every dispatch closes the slice the core was running and opens the next one
+    vector<vector<Slice>> slices(header.cores);
+    map<int, ProcessSummary> processes;
+    map<char, long long> kinds;
+    long long first = -1, last = 0, events = 0;
+    vector<TraceEvent> batch(TRACE_READ);
+    size_t n;
+    while ((n = fread(batch.data(), sizeof(TraceEvent), batch.size(), file)) > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            const TraceEvent &e = batch[i];
+            if (dump)
+            {
+                printEvent(e);
+            }
+            events++;
+            kinds[e.kind]++;
+            if (first < 0)
+            {
+                first = e.time;
+            }
+            last = e.time;
+            if (e.core >= header.cores)
+            {
+                continue;
+            }
+            switch (e.kind)
+            {
+            case TRACE_START:
+                processes[e.pid].start = e.time;
+                break;
+            case TRACE_DISPATCH:
+                if (e.core >= 0)
+                {
+                    vector<Slice> &core = slices[e.core];
+                    if (!core.empty() && core.back().to < 0)
+                    {
+                        core.back().to = e.time;
+                    }
+                    if (!core.empty() && core.back().pid == e.pid && core.back().to == e.time)
+                    {
+                        core.back().to = -1; // Same process again: the slice goes on
+                    }
+                    else
+                    {
+                        core.push_back(Slice{e.time, -1, e.pid});
+                    }
+                    if (e.pid >= 1)
+                    {
+                        processes[e.pid].dispatches++;
+                    }
+                }
+                break;
+            case TRACE_PREEMPT:
+                processes[e.pid].preemptions++;
+                break;
+            case TRACE_EXIT:
+                processes[e.pid].finish = e.time;
+                break;
+            case TRACE_BLOCK:
+                if (e.pid >= 1)
+                {
+                    processes[e.pid].blocks++;
+                }
+                break;
+            }
+        }
+    }
+    fclose(file);
+
+    long long busy = 0;
+    vector<long long> coreBusy(header.cores, 0);
+    for (int c = 0; c < header.cores; c++)
+    {
+        for (Slice &s : slices[c])
+        {
+            if (s.to < 0)
+            {
+                s.to = last; // Still running when the trace ended
+            }
+            if (s.pid >= 1)
+            {
+                processes[s.pid].cpu += s.to - s.from;
+                coreBusy[c] += s.to - s.from;
+                busy += s.to - s.from;
+            }
+        }
+    }
+
+    //----| Summary |----//
+    cout << "Trace of the " << header.policy << " scheduler, " << header.cores << " core(s), " << header.levels << " levels" << endl;
+    cout << events << " events over Time " << (first < 0 ? 0 : first) << " to " << last << ":";
+    for (map<char, long long>::iterator it = kinds.begin(); it != kinds.end(); ++it)
+    {
+        cout << " " << it->first << "=" << it->second;
+    }
+    cout << endl;
+    long long span = first < 0 ? 0 : last - first;
+    for (int c = 0; c < header.cores; c++)
+    {
+        cout << "Core " << c << ": busy " << coreBusy[c] << " ticks";
+        if (span > 0)
+        {
+            cout << " (" << 100.0 * coreBusy[c] / span << "%)";
+        }
+        cout << endl;
+    }
+    cout << setw(8) << "PID" << setw(10) << "start" << setw(10) << "finish" << setw(10) << "cpu" << setw(9) << "share%"
+         << setw(11) << "dispatches" << setw(12) << "preemptions" << setw(8) << "blocks" << endl;
+    for (map<int, ProcessSummary>::iterator it = processes.begin(); it != processes.end(); ++it)
+    {
+        const ProcessSummary &p = it->second;
+        cout << setw(8) << it->first << setw(10) << p.start << setw(10) << p.finish << setw(10) << p.cpu << setw(9)
+             << fixed << setprecision(2) << (busy > 0 ? 100.0 * p.cpu / busy : 0.0) << defaultfloat << setprecision(6)
+             << setw(11) << p.dispatches << setw(12) << p.preemptions << setw(8) << p.blocks << endl;
+    }
+
+    if (gantt)
+    {
+        printGantt(slices, from < 0 ? (first < 0 ? 0 : first) : from, to < 0 ? last : to, width);
+    }
+    return 0;
+}
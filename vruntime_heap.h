@@ -0,0 +1,208 @@
+#ifndef VRUNTIME_HEAP_H
+#define VRUNTIME_HEAP_H
+/*
+    Ready queue of the CFS engine: runnable PIDs ordered by virtual runtime in a 4-ary min-heap.
+    Each entry's 64-bit key is vruntime << 32 | arrival sequence, so equal vruntimes leave in FIFO order
+    and a comparison is one integer compare. Keys and PIDs are kept in separate arrays; the four
+    children of a node are adjacent keys, half a cache line, so a sift-down step touches one line.
+    pop() is O(log4 n), peek() is O(1).
+    Like the kernel's min_vruntime, the heap remembers the largest vruntime it has handed out and places
+    a newcomer (or a process back from a block) no earlier than that, so it cannot starve the others.
+    It also offers the QueueArray constructor and getters Process_Manager uses (with a single level, 0).
+    The sequence wraps after 2^32 pushes, which only affects the order of equal vruntimes.
+*/
+//====| STL Includes |====//
+#include <vector>
+#include <algorithm>
+#include <deque>
+
+//====| Local Includes |====//
+#include "image.h"
+
+//====| Namespaces |====//
+using namespace std;
+
+//====| Class Declaration |====//
+class VruntimeHeap
+{
+private:
+    vector<unsigned long long> keys; // Heap order
+    vector<int> pids;                // pids[i] belongs to keys[i]
+    unsigned int sequence;           // Arrival counter for the FIFO tie-break
+    long long floor;                 // Largest vruntime popped so far (min_vruntime)
+    mutable deque<int> ordered;      // Run order copy for Qview
+
+    void siftUp(int);
+    void siftDown(int);
+
+public:
+    class View;
+
+    //----| Constructor(s) |----//
+    VruntimeHeap(int /*levels*/ = 1) : sequence(0), floor(0) {} // Constructed like a QueueArray; there is one level
+
+    //----| Setters |----//
+    void push(int pid, long long vruntime); // Queues pid at max(vruntime, min_vruntime)
+    int pop();                              // Removes and returns the PID with the smallest vruntime; 0 if empty
+
+    //----| Getters |----//
+    int peek() const { return pids.empty() ? 0 : pids[0]; }
+    long long minVruntime() const { return floor; }
+    int QAsize() const { return pids.size(); }
+    int Qsize(int level) const { return level == 0 ? (int)pids.size() : 0; }
+    View Qview(int level) const; // Queued PIDs in run order (level 0 only); invalidated by the next Qview
+
+    //----| Checkpoint |----//
+    void save(ImageWriter &out) const
+    {
+        out.array(keys);
+        out.array(pids);
+        out.value(sequence);
+        out.value(floor);
+    }
+    bool load(ImageReader &in)
+    {
+        in.array(keys);
+        in.array(pids);
+        in.value(sequence);
+        in.value(floor);
+        return in.good() && keys.size() == pids.size();
+    }
+};
+
+/*
+    Iterable range over the run-order copy, usable in a range-based for loop.
+*/
+class VruntimeHeap::View
+{
+public:
+    typedef deque<int>::const_iterator const_iterator;
+    View() : first(), last() {}
+    View(const_iterator b, const_iterator e) : first(b), last(e) {}
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return last; }
+    int size() const { return last - first; }
+    bool empty() const { return first == last; }
+
+private:
+    const_iterator first;
+    const_iterator last;
+};
+
+//====| Class Definitions |====//
+
+//----| Setters |----//
+
+inline void VruntimeHeap::push(int pid, long long vruntime)
+{
+    if (vruntime < floor)
+    {
+        vruntime = floor;
+    }
+    keys.push_back((unsigned long long)vruntime << 32 | sequence++);
+    pids.push_back(pid);
+    siftUp(keys.size() - 1);
+}
+
+inline int VruntimeHeap::pop()
+{
+    if (pids.empty())
+    {
+        return 0;
+    }
+    int pid = pids[0];
+    floor = max(floor, (long long)(keys[0] >> 32));
+    keys[0] = keys.back();
+    pids[0] = pids.back();
+    keys.pop_back();
+    pids.pop_back();
+    if (!keys.empty())
+    {
+        siftDown(0);
+    }
+    return pid;
+}
+
+//----| Getters |----//
+
+/*
+    Sorting a copy keeps the heap itself untouched; this is only used for the P report.
+*/
+inline VruntimeHeap::View VruntimeHeap::Qview(int level) const
+{
+    ordered.clear();
+    if (level != 0)
+    {
+        return View(ordered.begin(), ordered.end());
+    }
+    vector<pair<unsigned long long, int>> entries(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        entries[i] = make_pair(keys[i], pids[i]);
+    }
+    sort(entries.begin(), entries.end());
+    for (const pair<unsigned long long, int> &entry : entries)
+    {
+        ordered.push_back(entry.second);
+    }
+    return View(ordered.begin(), ordered.end());
+}
+
+//----| Helpers |----//
+
+inline void VruntimeHeap::siftUp(int i)
+{
+    unsigned long long key = keys[i];
+    int pid = pids[i];
+    while (i > 0)
+    {
+        int parent = (i - 1) >> 2;
+        if (keys[parent] <= key)
+        {
+            break;
+        }
+        keys[i] = keys[parent];
+        pids[i] = pids[parent];
+        i = parent;
+    }
+    keys[i] = key;
+    pids[i] = pid;
+}
+
+/*
+    Moves the hole down to the smallest of up to four children until the key fits.
+*/
+inline void VruntimeHeap::siftDown(int i)
+{
+    int n = keys.size();
+    unsigned long long key = keys[i];
+    int pid = pids[i];
+    while (true)
+    {
+        int first = 4 * i + 1;
+        if (first >= n)
+        {
+            break;
+        }
+        int best = first;
+        int last = min(first + 4, n);
+        for (int c = first + 1; c < last; c++)
+        {
+            if (keys[c] < keys[best])
+            {
+                best = c;
+            }
+        }
+        if (keys[best] >= key)
+        {
+            break;
+        }
+        keys[i] = keys[best];
+        pids[i] = pids[best];
+        i = best;
+    }
+    keys[i] = key;
+    pids[i] = pid;
+}
+
+#endif